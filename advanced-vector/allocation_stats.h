@@ -0,0 +1,138 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+
+// Снимок статистики выделений памяти для одного типа элементов
+struct AllocationStats {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t allocated_bytes = 0;
+    size_t deallocated_bytes = 0;
+    size_t peak_bytes = 0;
+    // Количество переездов в новый буфер и число перенесённых при этом элементов
+    size_t growths = 0;
+    size_t relocated_elements = 0;
+
+    size_t LiveBytes() const noexcept {
+        return allocated_bytes - deallocated_bytes;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const AllocationStats& stats) {
+    using namespace std::literals;
+    return out << "Allocations: "sv << stats.allocations                 //
+               << ", Deallocations: "sv << stats.deallocations           //
+               << ", Allocated bytes: "sv << stats.allocated_bytes       //
+               << ", Live bytes: "sv << stats.LiveBytes()                //
+               << ", Peak bytes: "sv << stats.peak_bytes                 //
+               << ", Growths: "sv << stats.growths                       //
+               << ", Relocated elements: "sv << stats.relocated_elements;
+}
+
+// Политика по умолчанию: ничего не считает и полностью исчезает после оптимизации
+struct NoAllocationTracking {
+    static void OnAllocate(size_t /*bytes*/) noexcept {
+    }
+    static void OnDeallocate(size_t /*bytes*/) noexcept {
+    }
+    static void OnGrowth(size_t /*relocated_elements*/) noexcept {
+    }
+    static AllocationStats Snapshot() noexcept {
+        return {};
+    }
+    static void Reset() noexcept {
+    }
+};
+
+// Политика с подсчётом. Счётчики свои для каждого T и безопасны при работе из нескольких потоков
+template <typename T>
+class TrackAllocations {
+public:
+    static void OnAllocate(size_t bytes) noexcept {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        const size_t live = live_bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t peak = peak_bytes_.load(std::memory_order_relaxed);
+        while (live > peak && !peak_bytes_.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    static void OnDeallocate(size_t bytes) noexcept {
+        deallocations_.fetch_add(1, std::memory_order_relaxed);
+        deallocated_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        live_bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    static void OnGrowth(size_t relocated_elements) noexcept {
+        growths_.fetch_add(1, std::memory_order_relaxed);
+        relocated_elements_.fetch_add(relocated_elements, std::memory_order_relaxed);
+    }
+
+    static AllocationStats Snapshot() noexcept {
+        AllocationStats stats;
+        stats.allocations = allocations_.load(std::memory_order_relaxed);
+        stats.deallocations = deallocations_.load(std::memory_order_relaxed);
+        stats.allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed);
+        stats.deallocated_bytes = deallocated_bytes_.load(std::memory_order_relaxed);
+        stats.peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+        stats.growths = growths_.load(std::memory_order_relaxed);
+        stats.relocated_elements = relocated_elements_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // Обнуляет счётчики; пиковое значение начинает отсчёт от текущего объёма живой памяти
+    static void Reset() noexcept {
+        allocations_ = 0;
+        deallocations_ = 0;
+        allocated_bytes_ = 0;
+        deallocated_bytes_ = 0;
+        peak_bytes_ = live_bytes_.load();
+        growths_ = 0;
+        relocated_elements_ = 0;
+    }
+
+private:
+    static inline std::atomic<size_t> allocations_ = 0;
+    static inline std::atomic<size_t> deallocations_ = 0;
+    static inline std::atomic<size_t> allocated_bytes_ = 0;
+    static inline std::atomic<size_t> deallocated_bytes_ = 0;
+    static inline std::atomic<size_t> live_bytes_ = 0;
+    static inline std::atomic<size_t> peak_bytes_ = 0;
+    static inline std::atomic<size_t> growths_ = 0;
+    static inline std::atomic<size_t> relocated_elements_ = 0;
+};
+
+// Выбор политики для RawMemory<T> на этапе компиляции. Чтобы включить учёт для одного типа:
+//     template <>
+//     struct AllocationPolicy<MyType> {
+//         using type = TrackAllocations<MyType>;
+//     };
+// Макрос ADVANCED_VECTOR_TRACK_ALLOCATIONS включает учёт для всех типов сразу
+template <typename T>
+struct AllocationPolicy {
+#ifdef ADVANCED_VECTOR_TRACK_ALLOCATIONS
+    using type = TrackAllocations<T>;
+#else
+    using type = NoAllocationTracking;
+#endif
+};
+
+template <typename T>
+using AllocationPolicyFor = typename AllocationPolicy<T>::type;
+
+template <typename T>
+AllocationStats GetAllocationStats() noexcept {
+    return AllocationPolicyFor<T>::Snapshot();
+}
+
+template <typename T>
+void ResetAllocationStats() noexcept {
+    AllocationPolicyFor<T>::Reset();
+}
+
+template <typename T>
+void DumpAllocationStats(std::string_view type_name, std::ostream& out = std::cerr) {
+    out << type_name << ": " << GetAllocationStats<T>() << std::endl;
+}
\ No newline at end of file
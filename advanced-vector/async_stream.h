@@ -0,0 +1,264 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+// Асинхронный поток элементов на сопрограммах C++20. Производитель — сопрограмма, которая выдаёт
+// элементы через co_yield и может между ними ждать прихода данных (например, co_await на Event).
+// Потребитель — другая сопрограмма, забирающая элементы пачками прямо в Vector:
+//     AsyncStream<Packet> Parse(Connection& connection) {
+//         while (...) {
+//             co_await connection.Readable();
+//             co_yield ParsePacket(connection);
+//         }
+//     }
+//     Task Handle(AsyncStream<Packet> packets) {
+//         Vector<Packet> batch;
+//         while (co_await packets.CollectInto(batch, 64) != 0) {
+//             Process(batch);
+//             batch.Resize(0);
+//         }
+//     }
+// Пока пачка не набрана, co_yield кладёт элемент в вектор и продолжает производителя без приостановки,
+// а потоки не блокируются: ожидающая сопрограмма просто не выполняется. Всё работает в том потоке,
+// который возобновил производителя
+
+// Сопрограмма без результата, запускаемая сразу при вызове. Исключение из неё бросается в Get()
+class Task {
+public:
+    struct promise_type {
+        Task get_return_object() noexcept {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_never initial_suspend() noexcept {
+            return {};
+        }
+        // Кадр остаётся до уничтожения Task, чтобы можно было узнать, завершилась ли сопрограмма
+        std::suspend_always final_suspend() noexcept {
+            return {};
+        }
+        void return_void() noexcept {
+        }
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+
+        std::exception_ptr exception;
+    };
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    Task(Task&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {
+    }
+    Task& operator=(Task&& rhs) noexcept {
+        if (this != &rhs) {
+            Task tmp(std::move(rhs));
+            std::swap(handle_, tmp.handle_);
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    bool Done() const noexcept {
+        return handle_ && handle_.done();
+    }
+
+    // Бросает исключение, которым завершилась сопрограмма
+    void Get() const {
+        assert(Done());
+        if (handle_.promise().exception) {
+            std::rethrow_exception(handle_.promise().exception);
+        }
+    }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle) {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// Событие для однопоточного кода: co_await event приостанавливает сопрограмму до вызова Set().
+// Set() возобновляет ожидающих в порядке ожидания прямо в своём потоке
+class Event {
+public:
+    Event() = default;
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
+
+    bool IsSet() const noexcept {
+        return set_;
+    }
+
+    void Set() {
+        set_ = true;
+        Vector<std::coroutine_handle<>> waiters;
+        waiters.Swap(waiters_);
+        for (std::coroutine_handle<> waiter : waiters) {
+            waiter.resume();
+        }
+    }
+
+    void Reset() noexcept {
+        set_ = false;
+    }
+
+    auto operator co_await() noexcept {
+        struct Awaiter {
+            Event& event;
+
+            bool await_ready() const noexcept {
+                return event.set_;
+            }
+            void await_suspend(std::coroutine_handle<> waiter) {
+                event.waiters_.PushBack(waiter);
+            }
+            void await_resume() const noexcept {
+            }
+        };
+        return Awaiter{*this};
+    }
+
+private:
+    bool set_ = false;
+    Vector<std::coroutine_handle<>> waiters_;
+};
+
+template <typename T>
+class AsyncStream {
+public:
+    struct promise_type {
+        AsyncStream get_return_object() noexcept {
+            return AsyncStream(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        // Производитель запускается первым CollectInto
+        std::suspend_always initial_suspend() noexcept {
+            return {};
+        }
+
+        auto final_suspend() noexcept {
+            return ToConsumer{false, consumer};
+        }
+
+        auto yield_value(T value) {
+            assert(sink != nullptr);
+            sink->EmplaceBack(std::move(value));
+            return ToConsumer{sink->Size() - batch_start < batch, consumer};
+        }
+
+        void return_void() noexcept {
+        }
+
+        void unhandled_exception() noexcept {
+            exception = std::current_exception();
+        }
+
+        // Если ready == false, приостанавливает производителя и передаёт управление потребителю
+        struct ToConsumer {
+            bool ready;
+            std::coroutine_handle<> consumer;
+
+            bool await_ready() const noexcept {
+                return ready;
+            }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<>) const noexcept {
+                return consumer ? consumer : std::noop_coroutine();
+            }
+            void await_resume() const noexcept {
+            }
+        };
+
+        Vector<T>* sink = nullptr;
+        size_t batch_start = 0;
+        size_t batch = 0;
+        std::coroutine_handle<> consumer;
+        std::exception_ptr exception;
+    };
+
+    AsyncStream(const AsyncStream&) = delete;
+    AsyncStream& operator=(const AsyncStream&) = delete;
+    AsyncStream(AsyncStream&& other) noexcept
+        : handle_(std::exchange(other.handle_, nullptr)) {
+    }
+    AsyncStream& operator=(AsyncStream&& rhs) noexcept {
+        if (this != &rhs) {
+            AsyncStream tmp(std::move(rhs));
+            std::swap(handle_, tmp.handle_);
+        }
+        return *this;
+    }
+
+    ~AsyncStream() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    // Производитель завершился, и элементов больше не будет
+    bool Done() const noexcept {
+        return !handle_ || handle_.done();
+    }
+
+    // co_await stream.CollectInto(out, batch) дописывает в out до batch элементов и возвращает их число.
+    // Потребитель возобновляется, когда пачка набрана или поток закончился, поэтому 0 означает конец потока.
+    // Ёмкость out растёт не меньше чем вдвое, так что резервирование под каждую пачку не приводит
+    // к квадратичному числу переносов
+    auto CollectInto(Vector<T>& out, size_t batch) {
+        assert(batch > 0);
+        struct Awaiter {
+            std::coroutine_handle<promise_type> producer;
+            Vector<T>& out;
+            size_t batch;
+            size_t start;
+
+            bool await_ready() const noexcept {
+                return !producer || producer.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> consumer) {
+                if (out.Size() + batch > out.Capacity()) {
+                    out.Reserve(std::max(out.Size() + batch, out.Capacity() * 2));
+                }
+                promise_type& promise = producer.promise();
+                promise.sink = &out;
+                promise.batch_start = start;
+                promise.batch = batch;
+                promise.consumer = consumer;
+                return producer;
+            }
+
+            size_t await_resume() const {
+                if (producer) {
+                    promise_type& promise = producer.promise();
+                    promise.sink = nullptr;
+                    promise.consumer = nullptr;
+                    if (promise.exception) {
+                        std::rethrow_exception(std::exchange(promise.exception, nullptr));
+                    }
+                }
+                return out.Size() - start;
+            }
+        };
+        return Awaiter{handle_, out, batch, out.Size()};
+    }
+
+private:
+    explicit AsyncStream(std::coroutine_handle<promise_type> handle) noexcept
+        : handle_(handle) {
+    }
+
+    std::coroutine_handle<promise_type> handle_;
+};
\ No newline at end of file
@@ -0,0 +1,847 @@
+#include "benchmark.h"
+#include "container_ops.h"
+#include "gather.h"
+#include "matrix.h"
+#include "numeric.h"
+#include "parallel_copy.h"
+#include "pipeline.h"
+#include "scan.h"
+#include "set_ops.h"
+#include "static_vector.h"
+#include "test_types.h"
+#include "views.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+    using namespace bench::ops;
+
+    // POD размером в одну кэш-линию
+    struct Pod64 {
+        std::array<uint64_t, 8> words{};
+    };
+
+    template <typename T>
+    T MakeValue(size_t i);
+
+    template <>
+    int MakeValue<int>(size_t i) {
+        return static_cast<int>(i);
+    }
+
+    template <>
+    float MakeValue<float>(size_t i) {
+        return static_cast<float>(i % 100) * 0.25f;
+    }
+
+    template <>
+    uint64_t MakeValue<uint64_t>(size_t i) {
+        return i;
+    }
+
+    template <>
+    std::string MakeValue<std::string>(size_t i) {
+        // Строка длиннее буфера SSO, чтобы копирование требовало выделения памяти
+        return std::string(24, 'x') + std::to_string(i);
+    }
+
+    template <>
+    Obj MakeValue<Obj>(size_t i) {
+        return Obj(static_cast<int>(i));
+    }
+
+    template <>
+    C MakeValue<C>(size_t /*i*/) {
+        return C();
+    }
+
+    template <>
+    Pod64 MakeValue<Pod64>(size_t i) {
+        Pod64 pod;
+        pod.words.fill(i);
+        return pod;
+    }
+
+    template <typename Container, typename T>
+    Container MakeFilled(size_t size) {
+        Container container;
+        Reserve(container, size);
+        for (size_t i = 0; i < size; ++i) {
+            PushBack(container, MakeValue<T>(i));
+        }
+        return container;
+    }
+
+    template <typename Container, typename T>
+    void PushBackCase(bench::State& state) {
+        const size_t n = state.Range();
+        const T value = MakeValue<T>(n);
+        while (state.KeepRunning()) {
+            Container container;
+            for (size_t i = 0; i < n; ++i) {
+                PushBack(container, value);
+            }
+            bench::DoNotOptimize(container);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename Container, typename T>
+    void EmplaceBackCase(bench::State& state) {
+        const size_t n = state.Range();
+        const T value = MakeValue<T>(n);
+        while (state.KeepRunning()) {
+            Container container;
+            for (size_t i = 0; i < n; ++i) {
+                EmplaceBack(container, value);
+            }
+            bench::DoNotOptimize(container);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename Container, typename T>
+    void EmplaceFrontCase(bench::State& state) {
+        const size_t n = state.Range();
+        const T value = MakeValue<T>(n);
+        while (state.KeepRunning()) {
+            Container container;
+            for (size_t i = 0; i < n; ++i) {
+                EmplaceAt(container, 0, value);
+            }
+            bench::DoNotOptimize(container);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename Container, typename T>
+    void EmplaceMiddleCase(bench::State& state) {
+        const size_t n = state.Range();
+        const T value = MakeValue<T>(n);
+        while (state.KeepRunning()) {
+            Container container;
+            for (size_t i = 0; i < n; ++i) {
+                EmplaceAt(container, Size(container) / 2, value);
+            }
+            bench::DoNotOptimize(container);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename Container, typename T>
+    void EraseFrontCase(bench::State& state) {
+        const size_t n = state.Range();
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            Container container = MakeFilled<Container, T>(n);
+            state.ResumeTiming();
+            while (Size(container) != 0) {
+                EraseAt(container, 0);
+            }
+            bench::DoNotOptimize(container);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename Container, typename T>
+    void ReserveCase(bench::State& state) {
+        const size_t n = state.Range();
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            {
+                Container container = MakeFilled<Container, T>(n);
+                state.ResumeTiming();
+                Reserve(container, n * 2);
+                bench::DoNotOptimize(container);
+                state.PauseTiming();
+            }
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename Container, typename T>
+    void ResizeCase(bench::State& state) {
+        const size_t n = state.Range();
+        while (state.KeepRunning()) {
+            {
+                Container container;
+                Resize(container, n);
+                bench::DoNotOptimize(container);
+                state.PauseTiming();
+            }
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Заполнение заранее выделенного вектора n копиями VALUE: Assign против std::vector::assign.
+    // Ноль заполняется memset, остальные значения — блоками
+    template <typename Container, int VALUE>
+    void FillCase(bench::State& state) {
+        const size_t n = state.Range();
+        Container container(n);
+        while (state.KeepRunning()) {
+            if constexpr (std::is_same_v<Container, Vector<int>>) {
+                container.Assign(n, VALUE);
+            }
+            else {
+                container.assign(n, VALUE);
+            }
+            bench::DoNotOptimize(container);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename Container, typename T>
+    void CopyCase(bench::State& state) {
+        const size_t n = state.Range();
+        const Container source = MakeFilled<Container, T>(n);
+        while (state.KeepRunning()) {
+            {
+                Container copy(source);
+                bench::DoNotOptimize(copy);
+                state.PauseTiming();
+            }
+            state.ResumeTiming();
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename Container, typename T>
+    void MoveCase(bench::State& state) {
+        Container source = MakeFilled<Container, T>(state.Range());
+        while (state.KeepRunning()) {
+            Container moved(std::move(source));
+            bench::DoNotOptimize(moved);
+            source = std::move(moved);
+        }
+    }
+
+    // Размер маленьких векторов в SmallVectorsCase
+    constexpr size_t SMALL_SIZE = 16;
+
+    // Заполняет n / SMALL_SIZE векторов по SMALL_SIZE элементов, как при сборке коротких списков в цикле
+    template <typename Container, typename T>
+    void SmallVectorsCase(bench::State& state) {
+        const size_t n = state.Range();
+        const T value = MakeValue<T>(n);
+        while (state.KeepRunning()) {
+            for (size_t i = 0; i < n; i += SMALL_SIZE) {
+                Container container;
+                for (size_t j = 0; j < SMALL_SIZE; ++j) {
+                    PushBack(container, value);
+                }
+                bench::DoNotOptimize(container);
+            }
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Сравнение векторов, различающихся только последним элементом: == и <
+    template <typename Container>
+    void CompareCase(bench::State& state) {
+        const size_t n = state.Range();
+        Container lhs(n);
+        Container rhs(n);
+        rhs[n - 1] = 1;
+        while (state.KeepRunning()) {
+            bool result = lhs == rhs;
+            bench::DoNotOptimize(result);
+            result = lhs < rhs;
+            bench::DoNotOptimize(result);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Хеш вектора целиком против цикла, комбинирующего std::hash элементов
+    void HashCase(bench::State& state) {
+        const size_t n = state.Range();
+        const Vector<int> v(n);
+        while (state.KeepRunning()) {
+            size_t hash = v.Hash();
+            bench::DoNotOptimize(hash);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    void HashLoopCase(bench::State& state) {
+        const size_t n = state.Range();
+        const std::vector<int> v(n);
+        while (state.KeepRunning()) {
+            size_t hash = n;
+            for (int item : v) {
+                hash ^= std::hash<int>{}(item) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+            }
+            bench::DoNotOptimize(hash);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Отсортированное множество из n чисел со случайными промежутками в среднем по step,
+    // чтобы ветвления слияния нельзя было предсказать
+    template <typename Container>
+    Container MakeSortedSet(size_t n, uint32_t step) {
+        Container set(n);
+        std::mt19937_64 random(step);
+        uint32_t value = 0;
+        for (size_t i = 0; i < n; ++i) {
+            value += 1 + static_cast<uint32_t>(random() % (2 * step - 1));
+            set[i] = value;
+        }
+        return set;
+    }
+
+    enum class SetOp {
+        INTERSECT,
+        INTERSECT_SKEWED,
+        UNION,
+        DIFFERENCE,
+    };
+
+    // Операции над множествами с промежутками 2 и 3; при INTERSECT_SKEWED второе множество в 100 раз короче
+    // и разрежено так, что покрывает тот же диапазон чисел
+    template <SetOp OP>
+    void SetOpCase(bench::State& state) {
+        const size_t n = state.Range();
+        constexpr bool SKEWED = OP == SetOp::INTERSECT_SKEWED;
+        const auto a = MakeSortedSet<Vector<uint32_t>>(n, 2);
+        const auto b = MakeSortedSet<Vector<uint32_t>>(SKEWED ? n / 100 + 1 : n, SKEWED ? 300 : 3);
+        Vector<uint32_t> out;
+        while (state.KeepRunning()) {
+            if constexpr (OP == SetOp::UNION) {
+                Union(a, b, out);
+            }
+            else if constexpr (OP == SetOp::DIFFERENCE) {
+                Difference(a, b, out);
+            }
+            else {
+                Intersect(a, b, out);
+            }
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <SetOp OP>
+    void SetOpLoopCase(bench::State& state) {
+        const size_t n = state.Range();
+        constexpr bool SKEWED = OP == SetOp::INTERSECT_SKEWED;
+        const auto a = MakeSortedSet<std::vector<uint32_t>>(n, 2);
+        const auto b = MakeSortedSet<std::vector<uint32_t>>(SKEWED ? n / 100 + 1 : n, SKEWED ? 300 : 3);
+        std::vector<uint32_t> out;
+        while (state.KeepRunning()) {
+            out.clear();
+            if constexpr (OP == SetOp::UNION) {
+                out.reserve(a.size() + b.size());
+                std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+            }
+            else if constexpr (OP == SetOp::DIFFERENCE) {
+                out.reserve(a.size());
+                std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+            }
+            else {
+                out.reserve(std::min(a.size(), b.size()));
+                std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+            }
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Удаление повторов из вектора, где каждое число встречается в среднем дважды
+    template <typename Container>
+    void UniqueCase(bench::State& state) {
+        const size_t n = state.Range();
+        Container source(n);
+        std::mt19937_64 random(42);
+        for (size_t i = 0; i < n; ++i) {
+            source[i] = static_cast<uint32_t>(i + random() % 2) / 2;
+        }
+        std::sort(source.begin(), source.end());
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            Container v = source;
+            state.ResumeTiming();
+            if constexpr (std::is_same_v<Container, Vector<uint32_t>>) {
+                Unique(v);
+            }
+            else {
+                v.erase(std::unique(v.begin(), v.end()), v.end());
+            }
+            bench::DoNotOptimize(v);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Префиксная сумма: InclusiveScan (последовательный или параллельный) против std::inclusive_scan
+    template <typename T, bool PARALLEL>
+    void ScanCase(bench::State& state) {
+        const size_t n = state.Range();
+        const Vector<T> in = MakeFilled<Vector<T>, T>(n);
+        Vector<T> out;
+        while (state.KeepRunning()) {
+            T total = PARALLEL ? ParallelInclusiveScan(in, out) : InclusiveScan(in, out);
+            bench::DoNotOptimize(total);
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    template <typename T>
+    void ScanLoopCase(bench::State& state) {
+        const size_t n = state.Range();
+        const std::vector<T> in = MakeFilled<std::vector<T>, T>(n);
+        std::vector<T> out(n);
+        while (state.KeepRunning()) {
+            std::inclusive_scan(in.begin(), in.end(), out.begin());
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Гистограмма 256 корзин, где половина ключей одинакова, против простого цикла
+    template <bool PARALLEL>
+    void HistogramCase(bench::State& state) {
+        const size_t n = state.Range();
+        Vector<uint32_t> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = i % 2 == 0 ? 0 : static_cast<uint32_t>(i * 7919 % 256);
+        }
+        Vector<size_t> counts;
+        while (state.KeepRunning()) {
+            if constexpr (PARALLEL) {
+                ParallelHistogram(keys, 256, counts);
+            }
+            else {
+                Histogram(keys, 256, counts);
+            }
+            bench::DoNotOptimize(counts);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    void HistogramLoopCase(bench::State& state) {
+        const size_t n = state.Range();
+        std::vector<uint32_t> keys(n);
+        for (size_t i = 0; i < n; ++i) {
+            keys[i] = i % 2 == 0 ? 0 : static_cast<uint32_t>(i * 7919 % 256);
+        }
+        std::vector<size_t> counts;
+        while (state.KeepRunning()) {
+            counts.assign(256, 0);
+            for (uint32_t key : keys) {
+                ++counts[key];
+            }
+            bench::DoNotOptimize(counts);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // c = a * x + b: выражение numeric против написанного вручную цикла над std::vector
+    void AxpyCase(bench::State& state) {
+        const size_t n = state.Range();
+        Vector<float> a(n);
+        Vector<float> b(n);
+        Vector<float> c(n);
+        const float x = 1.5f;
+        while (state.KeepRunning()) {
+            using namespace numeric;
+            c = a * x + b;
+            bench::DoNotOptimize(c);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    void AxpyLoopCase(bench::State& state) {
+        const size_t n = state.Range();
+        std::vector<float> a(n);
+        std::vector<float> b(n);
+        std::vector<float> c(n);
+        const float x = 1.5f;
+        while (state.KeepRunning()) {
+            for (size_t i = 0; i < n; ++i) {
+                c[i] = a[i] * x + b[i];
+            }
+            bench::DoNotOptimize(c);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Отбор чётных чисел и возведение в квадрат: ленивый конвейер views против промежуточного
+    // std::vector после каждой стадии
+    void FilterTransformCase(bench::State& state) {
+        const size_t n = state.Range();
+        Vector<int> source;
+        for (size_t i = 0; i < n; ++i) {
+            source.PushBack(static_cast<int>(i));
+        }
+        while (state.KeepRunning()) {
+            Vector<int> out;
+            source | views::Filter([](int i) {
+                return i % 2 == 0;
+            }) | views::Transform([](int i) {
+                return i * i;
+            }) | views::CollectInto(out);
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    void FilterTransformMaterializedCase(bench::State& state) {
+        const size_t n = state.Range();
+        std::vector<int> source;
+        for (size_t i = 0; i < n; ++i) {
+            source.push_back(static_cast<int>(i));
+        }
+        while (state.KeepRunning()) {
+            std::vector<int> filtered;
+            for (int i : source) {
+                if (i % 2 == 0) {
+                    filtered.push_back(i);
+                }
+            }
+            std::vector<int> out;
+            out.reserve(filtered.size());
+            for (int i : filtered) {
+                out.push_back(i * i);
+            }
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Три стадии (преобразование, отбор, сумма) над участками, пока они в кэше, против трёх
+    // последовательных проходов по всему std::vector
+    template <bool Threaded>
+    void PipelineCase(bench::State& state) {
+        const size_t n = state.Range();
+        int64_t sum = 0;
+        Pipeline<int> pipeline;
+        pipeline.AddTransform([](int& i) {
+                    i = i * 3 + 1;
+                })
+            .AddFilter([](int i) {
+                return i % 4 != 0;
+            })
+            .AddStage([&sum](views::Span<int> chunk) {
+                for (int i : chunk) {
+                    sum += i;
+                }
+                return chunk.Size();
+            });
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            Vector<int> data = MakeFilled<Vector<int>, int>(n);
+            state.ResumeTiming();
+            if constexpr (Threaded) {
+                pipeline.RunThreaded(data);
+            }
+            else {
+                pipeline.Run(data);
+            }
+            bench::DoNotOptimize(data);
+        }
+        bench::DoNotOptimize(sum);
+        state.SetItemsProcessed(n);
+    }
+
+    void StagePassesCase(bench::State& state) {
+        const size_t n = state.Range();
+        int64_t sum = 0;
+        while (state.KeepRunning()) {
+            state.PauseTiming();
+            std::vector<int> data = MakeFilled<std::vector<int>, int>(n);
+            state.ResumeTiming();
+            for (int& i : data) {
+                i = i * 3 + 1;
+            }
+            data.erase(std::remove_if(data.begin(), data.end(), [](int i) {
+                           return i % 4 == 0;
+                       }),
+                       data.end());
+            for (int i : data) {
+                sum += i;
+            }
+            bench::DoNotOptimize(data);
+        }
+        bench::DoNotOptimize(sum);
+        state.SetItemsProcessed(n);
+    }
+
+    // Транспонирование квадратной матрицы из Range() элементов: блоками против построчного цикла
+    size_t MatrixSide(size_t n) {
+        return std::max<size_t>(static_cast<size_t>(std::sqrt(static_cast<double>(n))), 1);
+    }
+
+    void TransposeCase(bench::State& state) {
+        const size_t side = MatrixSide(state.Range());
+        const Vector<float> src(side * side);
+        Vector<float> dst(side * side);
+        while (state.KeepRunning()) {
+            Transpose(MatrixView<const float>(src, side, side), MatrixView<float>(dst, side, side));
+            bench::DoNotOptimize(dst);
+        }
+        state.SetItemsProcessed(side * side);
+    }
+
+    void TransposeLoopCase(bench::State& state) {
+        const size_t side = MatrixSide(state.Range());
+        const std::vector<float> src(side * side);
+        std::vector<float> dst(side * side);
+        while (state.KeepRunning()) {
+            for (size_t i = 0; i < side; ++i) {
+                for (size_t j = 0; j < side; ++j) {
+                    dst[j * side + i] = src[i * side + j];
+                }
+            }
+            bench::DoNotOptimize(dst);
+        }
+        state.SetItemsProcessed(side * side);
+    }
+
+    // Перестановка 0..n-1 в случайном порядке
+    template <typename Index>
+    std::vector<Index> RandomPermutation(size_t n) {
+        std::vector<Index> permutation(n);
+        std::iota(permutation.begin(), permutation.end(), Index(0));
+        std::shuffle(permutation.begin(), permutation.end(), std::mt19937_64(42));
+        return permutation;
+    }
+
+    // out[i] = data[indices[i]] при случайных индексах: Gather с предвыборкой против простого цикла
+    void GatherCase(bench::State& state) {
+        const size_t n = state.Range();
+        const Vector<int> data(n);
+        Vector<uint32_t> indices;
+        for (uint32_t index : RandomPermutation<uint32_t>(n)) {
+            indices.PushBack(index);
+        }
+        Vector<int> out;
+        while (state.KeepRunning()) {
+            Gather(data, indices, out);
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    void GatherLoopCase(bench::State& state) {
+        const size_t n = state.Range();
+        const std::vector<int> data(n);
+        const std::vector<uint32_t> indices = RandomPermutation<uint32_t>(n);
+        std::vector<int> out;
+        while (state.KeepRunning()) {
+            out.clear();
+            out.reserve(n);
+            for (uint32_t index : indices) {
+                out.push_back(data[index]);
+            }
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    void ParallelGatherCase(bench::State& state) {
+        const size_t n = state.Range();
+        const Vector<int> data(n);
+        Vector<uint32_t> indices;
+        for (uint32_t index : RandomPermutation<uint32_t>(n)) {
+            indices.PushBack(index);
+        }
+        Vector<int> out;
+        while (state.KeepRunning()) {
+            ParallelGather(data, indices, out);
+            bench::DoNotOptimize(out);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // data[indices[i]] += values[i] при случайных индексах, каждый из которых повторяется в среднем 4 раза
+    enum class ScatterMode {
+        PLAIN,
+        GROUPED,
+        PARALLEL,
+    };
+
+    template <ScatterMode MODE>
+    void ScatterAddCase(bench::State& state) {
+        const size_t n = state.Range();
+        Vector<int> data(n);
+        Vector<uint32_t> indices;
+        for (uint32_t index : RandomPermutation<uint32_t>(n)) {
+            indices.PushBack(index / 4);
+        }
+        const Vector<int> values(n);
+        ScatterBuffer<int, uint32_t> buffer;
+        while (state.KeepRunning()) {
+            if constexpr (MODE == ScatterMode::PLAIN) {
+                ScatterAdd(data, indices, values);
+            }
+            else if constexpr (MODE == ScatterMode::GROUPED) {
+                ScatterAddGrouped(data, indices, values, buffer);
+            }
+            else {
+                ParallelScatterAdd(data, indices, values, buffer);
+            }
+            bench::DoNotOptimize(data);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    void ScatterAddLoopCase(bench::State& state) {
+        const size_t n = state.Range();
+        std::vector<int> data(n);
+        std::vector<uint32_t> indices = RandomPermutation<uint32_t>(n);
+        for (uint32_t& index : indices) {
+            index /= 4;
+        }
+        const std::vector<int> values(n);
+        while (state.KeepRunning()) {
+            for (size_t i = 0; i < n; ++i) {
+                data[indices[i]] += values[i];
+            }
+            bench::DoNotOptimize(data);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Сумма по вектору указателей на разбросанные по памяти объекты размером в кэш-линию
+    void PointerScanCase(bench::State& state) {
+        const size_t n = state.Range();
+        const std::vector<Pod64> objects(n);
+        Vector<const Pod64*> pointers;
+        for (size_t index : RandomPermutation<size_t>(n)) {
+            pointers.PushBack(&objects[index]);
+        }
+        while (state.KeepRunning()) {
+            uint64_t sum = 0;
+            for (const Pod64* object : Prefetching(pointers)) {
+                sum += object->words[0];
+            }
+            bench::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    void PointerScanLoopCase(bench::State& state) {
+        const size_t n = state.Range();
+        const std::vector<Pod64> objects(n);
+        std::vector<const Pod64*> pointers;
+        for (size_t index : RandomPermutation<size_t>(n)) {
+            pointers.push_back(&objects[index]);
+        }
+        while (state.KeepRunning()) {
+            uint64_t sum = 0;
+            for (const Pod64* object : pointers) {
+                sum += object->words[0];
+            }
+            bench::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(n);
+    }
+
+    // Копирование вектора ParallelAssign против memcpy в заранее выделенный буфер. Обработанными
+    // считаются байты, поэтому скорость читается как ГБ/с
+    void BulkCopyCase(bench::State& state) {
+        const size_t n = state.Range();
+        const Vector<uint64_t> from = MakeFilled<Vector<uint64_t>, uint64_t>(n);
+        Vector<uint64_t> to(n);
+        while (state.KeepRunning()) {
+            ParallelAssign(to, from);
+            bench::DoNotOptimize(to);
+        }
+        state.SetItemsProcessed(n * sizeof(uint64_t));
+    }
+
+    void MemcpyCase(bench::State& state) {
+        const size_t n = state.Range();
+        const std::vector<uint64_t> from = MakeFilled<std::vector<uint64_t>, uint64_t>(n);
+        std::vector<uint64_t> to(n);
+        while (state.KeepRunning()) {
+            std::memcpy(to.data(), from.data(), n * sizeof(uint64_t));
+            bench::DoNotOptimize(to);
+        }
+        state.SetItemsProcessed(n * sizeof(uint64_t));
+    }
+
+    template <typename T>
+    void RegisterCases(const std::string& type_name) {
+        using V = Vector<T>;
+        using S = std::vector<T>;
+        bench::Register("PushBack<" + type_name + ">", PushBackCase<V, T>, PushBackCase<S, T>);
+        bench::Register("EmplaceBack<" + type_name + ">", EmplaceBackCase<V, T>, EmplaceBackCase<S, T>);
+        bench::Register("EmplaceFront<" + type_name + ">", EmplaceFrontCase<V, T>, EmplaceFrontCase<S, T>, true);
+        bench::Register("EmplaceMiddle<" + type_name + ">", EmplaceMiddleCase<V, T>, EmplaceMiddleCase<S, T>, true);
+        bench::Register("EraseFront<" + type_name + ">", EraseFrontCase<V, T>, EraseFrontCase<S, T>, true);
+        bench::Register("Reserve<" + type_name + ">", ReserveCase<V, T>, ReserveCase<S, T>);
+        bench::Register("Resize<" + type_name + ">", ResizeCase<V, T>, ResizeCase<S, T>);
+        bench::Register("Copy<" + type_name + ">", CopyCase<V, T>, CopyCase<S, T>);
+        bench::Register("Move<" + type_name + ">", MoveCase<V, T>, MoveCase<S, T>);
+        bench::Register("SmallVectors<" + type_name + ">", SmallVectorsCase<V, T>, SmallVectorsCase<S, T>);
+        // Вместо Vector измеряется BoundedVector<T, SMALL_SIZE>
+        bench::Register("SmallVectors<" + type_name + ">/Bounded", SmallVectorsCase<BoundedVector<T, SMALL_SIZE>, T>,
+                        SmallVectorsCase<S, T>);
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const bench::Options options = bench::ParseOptions(argc, argv);
+        RegisterCases<int>("int");
+        RegisterCases<std::string>("string");
+        RegisterCases<Obj>("Obj");
+        RegisterCases<C>("C");
+        RegisterCases<Pod64>("Pod64");
+        bench::Register("Compare<int>", CompareCase<Vector<int>>, CompareCase<std::vector<int>>);
+        bench::Register("Hash<int>", HashCase, HashLoopCase);
+        bench::Register("Intersect<uint32_t>", SetOpCase<SetOp::INTERSECT>, SetOpLoopCase<SetOp::INTERSECT>);
+        bench::Register("Intersect<uint32_t>/Skewed", SetOpCase<SetOp::INTERSECT_SKEWED>,
+                        SetOpLoopCase<SetOp::INTERSECT_SKEWED>);
+        bench::Register("Union<uint32_t>", SetOpCase<SetOp::UNION>, SetOpLoopCase<SetOp::UNION>);
+        bench::Register("Difference<uint32_t>", SetOpCase<SetOp::DIFFERENCE>, SetOpLoopCase<SetOp::DIFFERENCE>);
+        bench::Register("Unique<uint32_t>", UniqueCase<Vector<uint32_t>>, UniqueCase<std::vector<uint32_t>>);
+        bench::Register("Scan<int>", ScanCase<int, false>, ScanLoopCase<int>);
+        bench::Register("Scan<float>", ScanCase<float, false>, ScanLoopCase<float>);
+        bench::Register("Scan<int>/Parallel", ScanCase<int, true>, ScanLoopCase<int>);
+        bench::Register("Histogram<uint32_t>", HistogramCase<false>, HistogramLoopCase);
+        bench::Register("Histogram<uint32_t>/Parallel", HistogramCase<true>, HistogramLoopCase);
+        bench::Register("Axpy<float>", AxpyCase, AxpyLoopCase);
+        bench::Register("FilterTransform<int>", FilterTransformCase, FilterTransformMaterializedCase);
+        bench::Register("Gather<int>", GatherCase, GatherLoopCase);
+        bench::Register("Gather<int>/Parallel", ParallelGatherCase, GatherLoopCase);
+        bench::Register("ScatterAdd<int>", ScatterAddCase<ScatterMode::PLAIN>, ScatterAddLoopCase);
+        bench::Register("ScatterAdd<int>/Grouped", ScatterAddCase<ScatterMode::GROUPED>, ScatterAddLoopCase);
+        bench::Register("ScatterAdd<int>/Parallel", ScatterAddCase<ScatterMode::PARALLEL>, ScatterAddLoopCase);
+        bench::Register("PointerScan<Pod64>", PointerScanCase, PointerScanLoopCase);
+        bench::Register("Transpose<float>", TransposeCase, TransposeLoopCase);
+        bench::Register("Pipeline<int>", PipelineCase<false>, StagePassesCase);
+        bench::Register("Pipeline<int>/Threaded", PipelineCase<true>, StagePassesCase);
+        // Вместо Vector измеряются IncrementalVector и PregrowingVector: цена их режимов роста
+        bench::Register("PushBack<int>/Incremental", PushBackCase<IncrementalVector<int>, int>,
+                        PushBackCase<std::vector<int>, int>);
+        bench::Register("PushBack<int>/Pregrowing", PushBackCase<PregrowingVector<int>, int>,
+                        PushBackCase<std::vector<int>, int>);
+        bench::Register("BulkCopy<uint64_t>", BulkCopyCase, MemcpyCase);
+        bench::Register("Fill<int>", FillCase<Vector<int>, 0x01020304>, FillCase<std::vector<int>, 0x01020304>);
+        bench::Register("Fill<int>/Zero", FillCase<Vector<int>, 0>, FillCase<std::vector<int>, 0>);
+        bench::RunAll(options);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,403 @@
+#pragma once
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Минимальный каркас микробенчмарков в духе Google Benchmark:
+// калибровка числа итераций, повторы и статистика (медиана, среднее, стандартное отклонение)
+namespace bench {
+
+// Не даёт компилятору выбросить вычисление value
+template <typename T>
+inline void DoNotOptimize(T&& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile void* sink = &value;
+    (void)sink;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+struct Options {
+    size_t repetitions = 5;
+    size_t max_size = 1'000'000;
+    // Ограничение размера для операций с квадратичной сложностью (вставка в начало и т.п.)
+    size_t quadratic_max_size = 10'000;
+    double min_time = 0.1;
+    std::string filter;
+    // Снимать аппаратные счётчики perf_event вокруг каждого случая
+    bool perf_counters = false;
+};
+
+inline Options ParseOptions(int argc, char* argv[]) {
+    using namespace std::literals;
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const auto eq = arg.find('=');
+        const auto name = arg.substr(0, eq);
+        const std::string value(eq == std::string_view::npos ? ""sv : arg.substr(eq + 1));
+        if (name == "--repetitions"sv) {
+            options.repetitions = std::max<size_t>(1, std::stoull(value));
+        }
+        else if (name == "--max-size"sv) {
+            options.max_size = static_cast<size_t>(std::stod(value));
+        }
+        else if (name == "--quadratic-max-size"sv) {
+            options.quadratic_max_size = static_cast<size_t>(std::stod(value));
+        }
+        else if (name == "--min-time"sv) {
+            options.min_time = std::stod(value);
+        }
+        else if (name == "--filter"sv) {
+            options.filter = value;
+        }
+        else if (name == "--perf-counters"sv) {
+            options.perf_counters = value.empty() || value == "1"sv || value == "true"sv;
+        }
+        else {
+            throw std::invalid_argument("Unknown option: "s + std::string(arg));
+        }
+    }
+    return options;
+}
+
+class State {
+public:
+    State(size_t range, size_t max_iterations, PerfCounters* counters = nullptr)
+        : range_(range), max_iterations_(max_iterations), counters_(counters) {
+    }
+
+    size_t Range() const noexcept {
+        return range_;
+    }
+
+    // Первый вызов запускает таймер, последний (возвращающий false) — останавливает
+    bool KeepRunning() {
+        if (!started_) {
+            started_ = true;
+            ResumeTiming();
+        }
+        if (iterations_ < max_iterations_) {
+            ++iterations_;
+            return true;
+        }
+        PauseTiming();
+        return false;
+    }
+
+    // Счётчики perf_event останавливаются вместе с таймером, чтобы подготовка данных в них не попадала
+    void PauseTiming() {
+        if (running_) {
+            elapsed_ += Clock::now() - start_;
+            running_ = false;
+            if (counters_ != nullptr) {
+                counters_->Stop();
+            }
+        }
+    }
+
+    void ResumeTiming() {
+        if (!running_) {
+            if (counters_ != nullptr) {
+                counters_->Start();
+            }
+            running_ = true;
+            start_ = Clock::now();
+        }
+    }
+
+    // Количество элементов, обрабатываемых за одну итерацию
+    void SetItemsProcessed(size_t items) noexcept {
+        items_ = items;
+    }
+
+    size_t ItemsProcessed() const noexcept {
+        return items_;
+    }
+
+    size_t Iterations() const noexcept {
+        return iterations_;
+    }
+
+    double ElapsedSeconds() const noexcept {
+        return std::chrono::duration<double>(elapsed_).count();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    size_t range_;
+    size_t max_iterations_;
+    size_t iterations_ = 0;
+    size_t items_ = 1;
+    PerfCounters* counters_;
+    bool started_ = false;
+    bool running_ = false;
+    Clock::time_point start_;
+    Clock::duration elapsed_{};
+};
+
+using Function = std::function<void(State&)>;
+
+struct Statistics {
+    size_t iterations = 0;
+    size_t items = 1;
+    // Время одной итерации в наносекундах
+    double median_ns = 0;
+    double mean_ns = 0;
+    double stddev_ns = 0;
+    // Показания счётчиков на один обработанный элемент, если они снимались
+    bool has_counters = false;
+    PerfCounters::Values counters_per_item{};
+};
+
+inline double Median(std::vector<double> values) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    const size_t mid = values.size() / 2;
+    return values.size() % 2 != 0 ? values[mid] : (values[mid - 1] + values[mid]) / 2;
+}
+
+inline double Mean(const std::vector<double>& values) {
+    double sum = 0;
+    for (double value : values) {
+        sum += value;
+    }
+    return values.empty() ? 0 : sum / static_cast<double>(values.size());
+}
+
+inline double StdDev(const std::vector<double>& values) {
+    if (values.size() < 2) {
+        return 0;
+    }
+    const double mean = Mean(values);
+    double sum = 0;
+    for (double value : values) {
+        sum += (value - mean) * (value - mean);
+    }
+    return std::sqrt(sum / static_cast<double>(values.size() - 1));
+}
+
+// Подбирает число итераций так, чтобы один повтор длился не меньше min_time,
+// затем выполняет options.repetitions повторов. Счётчики, если переданы, снимаются только в повторах
+inline Statistics Measure(const Function& function, size_t range, const Options& options,
+                          PerfCounters* counters = nullptr) {
+    size_t iterations = 1;
+    while (true) {
+        State state(range, iterations);
+        function(state);
+        const double elapsed = state.ElapsedSeconds();
+        if (elapsed >= options.min_time || iterations >= 1'000'000'000) {
+            break;
+        }
+        const double multiplier = elapsed > 0 ? options.min_time * 1.4 / elapsed : 10.0;
+        iterations = static_cast<size_t>(static_cast<double>(iterations) * std::clamp(multiplier, 1.5, 10.0)) + 1;
+    }
+
+    Statistics stats;
+    stats.iterations = iterations;
+    std::vector<double> samples;
+    samples.reserve(options.repetitions);
+    if (counters != nullptr) {
+        counters->Reset();
+    }
+    for (size_t i = 0; i < options.repetitions; ++i) {
+        State state(range, iterations, counters);
+        function(state);
+        stats.items = state.ItemsProcessed();
+        samples.push_back(state.ElapsedSeconds() * 1e9 / static_cast<double>(state.Iterations()));
+    }
+    if (counters != nullptr) {
+        const double items = static_cast<double>(iterations * options.repetitions * std::max<size_t>(stats.items, 1));
+        stats.has_counters = true;
+        stats.counters_per_item = counters->Read();
+        for (double& value : stats.counters_per_item) {
+            if (value >= 0) {
+                value /= items;
+            }
+        }
+    }
+    stats.median_ns = Median(samples);
+    stats.mean_ns = Mean(samples);
+    stats.stddev_ns = StdDev(samples);
+    return stats;
+}
+
+// Случай бенчмарка: измеряемая реализация и (необязательно) эталон для сравнения
+struct Case {
+    std::string name;
+    Function subject;
+    Function baseline;
+    bool quadratic = false;
+};
+
+inline std::vector<Case>& Registry() {
+    static std::vector<Case> cases;
+    return cases;
+}
+
+inline void Register(std::string name, Function subject, Function baseline = {}, bool quadratic = false) {
+    Registry().push_back({std::move(name), std::move(subject), std::move(baseline), quadratic});
+}
+
+inline std::string FormatTime(double ns) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(ns < 10 ? 2 : 1);
+    if (ns < 1e3) {
+        out << ns << " ns";
+    }
+    else if (ns < 1e6) {
+        out << ns / 1e3 << " us";
+    }
+    else if (ns < 1e9) {
+        out << ns / 1e6 << " ms";
+    }
+    else {
+        out << ns / 1e9 << " s";
+    }
+    return out.str();
+}
+
+inline std::string FormatRate(double items_per_second) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    if (items_per_second >= 1e9) {
+        out << items_per_second / 1e9 << "G/s";
+    }
+    else if (items_per_second >= 1e6) {
+        out << items_per_second / 1e6 << "M/s";
+    }
+    else if (items_per_second >= 1e3) {
+        out << items_per_second / 1e3 << "k/s";
+    }
+    else {
+        out << items_per_second << "/s";
+    }
+    return out.str();
+}
+
+class Reporter {
+public:
+    explicit Reporter(std::ostream& out)
+        : out_(out) {
+    }
+
+    void PrintContext(const Options& options) const {
+        out_ << "Run on " << std::thread::hardware_concurrency() << " CPU(s), "
+             << options.repetitions << " repetition(s), min time " << options.min_time << " s" << std::endl;
+#ifndef NDEBUG
+        out_ << "***WARNING*** Benchmark was built with assertions enabled, timings may be affected" << std::endl;
+#endif
+    }
+
+    void PrintHeader() const {
+        out_ << std::left << std::setw(NAME_WIDTH) << "Benchmark" << std::setw(VARIANT_WIDTH) << "Variant"
+             << std::right << std::setw(12) << "Median" << std::setw(12) << "Mean" << std::setw(9) << "CV"
+             << std::setw(12) << "Iterations" << std::setw(14) << "Items" << std::setw(10) << "Ratio" << '\n'
+             << std::string(NAME_WIDTH + VARIANT_WIDTH + 69, '-') << std::endl;
+    }
+
+    // ratio — отношение медианного времени к эталону, 0 — эталона нет
+    void PrintRow(std::string_view name, std::string_view variant, const Statistics& stats, double ratio = 0) const {
+        const double cv = stats.mean_ns > 0 ? stats.stddev_ns / stats.mean_ns * 100 : 0;
+        const double rate = stats.median_ns > 0 ? static_cast<double>(stats.items) * 1e9 / stats.median_ns : 0;
+        std::ostringstream cv_text;
+        cv_text << std::fixed << std::setprecision(1) << cv << '%';
+        out_ << std::left << std::setw(NAME_WIDTH) << name << std::setw(VARIANT_WIDTH) << variant << std::right
+             << std::setw(12) << FormatTime(stats.median_ns) << std::setw(12) << FormatTime(stats.mean_ns)
+             << std::setw(9) << cv_text.str() << std::setw(12) << stats.iterations << std::setw(14) << FormatRate(rate);
+        if (ratio > 0) {
+            std::ostringstream ratio_text;
+            ratio_text << std::fixed << std::setprecision(2) << ratio << 'x';
+            out_ << std::setw(10) << ratio_text.str();
+        }
+        out_ << std::endl;
+        if (stats.has_counters) {
+            PrintCounters(stats.counters_per_item);
+        }
+    }
+
+    void PrintCounters(const PerfCounters::Values& per_item) const {
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(3) << std::string(NAME_WIDTH, ' ') << "  per item:";
+        for (size_t i = 0; i < PerfCounters::EVENT_COUNT; ++i) {
+            if (per_item[i] >= 0) {
+                line << ' ' << PerfCounters::NAMES[i] << '=' << per_item[i];
+            }
+        }
+        const double cycles = per_item[PerfCounters::CYCLES];
+        const double instructions = per_item[PerfCounters::INSTRUCTIONS];
+        if (cycles > 0 && instructions >= 0) {
+            line << " IPC=" << instructions / cycles;
+        }
+        out_ << line.str() << std::endl;
+    }
+
+private:
+    static constexpr int NAME_WIDTH = 40;
+    static constexpr int VARIANT_WIDTH = 14;
+
+    std::ostream& out_;
+};
+
+// Прогоняет все зарегистрированные случаи на размерах 1, 10, 100, ... до options.max_size
+inline void RunAll(const Options& options, std::ostream& out = std::cout) {
+    Reporter reporter(out);
+    reporter.PrintContext(options);
+    std::unique_ptr<PerfCounters> counters;
+    if (options.perf_counters) {
+        counters = std::make_unique<PerfCounters>();
+        if (!counters->IsAvailable()) {
+            out << "***WARNING*** perf counters are unavailable (" << counters->Error() << "), reporting time only"
+                << std::endl;
+            counters.reset();
+        }
+        else if (!counters->Error().empty()) {
+            out << "***WARNING*** some perf counters are unavailable (" << counters->Error() << ")" << std::endl;
+        }
+    }
+    reporter.PrintHeader();
+    for (const Case& benchmark_case : Registry()) {
+        const size_t max_size = benchmark_case.quadratic ? std::min(options.max_size, options.quadratic_max_size)
+                                                         : options.max_size;
+        for (size_t range = 1; range <= max_size; range *= 10) {
+            const std::string name = benchmark_case.name + "/" + std::to_string(range);
+            if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+            const Statistics subject = Measure(benchmark_case.subject, range, options, counters.get());
+            if (benchmark_case.baseline) {
+                const Statistics baseline = Measure(benchmark_case.baseline, range, options, counters.get());
+                reporter.PrintRow(name, "Vector", subject,
+                                  baseline.median_ns > 0 ? subject.median_ns / baseline.median_ns : 0);
+                reporter.PrintRow("", "std::vector", baseline);
+            }
+            else {
+                reporter.PrintRow(name, "Vector", subject);
+            }
+            if (range > max_size / 10) {
+                break;
+            }
+        }
+    }
+}
+
+}  // namespace bench
\ No newline at end of file
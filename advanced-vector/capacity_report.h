@@ -0,0 +1,228 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <type_traits>
+#include <typeinfo>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+// Реестр живых векторов для оценки памяти, уходящей на запас ёмкости.
+// Векторы регистрируются в нём, только если собраны с макросом ADVANCED_VECTOR_TRACK_CAPACITY
+
+inline std::string DemangleTypeName(const std::type_info& type) {
+#if defined(__GNUG__)
+    int status = 0;
+    std::unique_ptr<char, decltype(&std::free)> name(abi::__cxa_demangle(type.name(), nullptr, nullptr, &status),
+                                                     &std::free);
+    if (status == 0 && name) {
+        return name.get();
+    }
+#endif
+    return type.name();
+}
+
+struct CapacityReport {
+    // Утилизация Size() / Capacity() живых векторов с ненулевой ёмкостью, корзины по 10%.
+    // Последняя корзина — полностью заполненные векторы
+    static constexpr size_t UTILIZATION_BUCKETS = 11;
+    // Переезды в новый буфер, корзина i — новая ёмкость в диапазоне [2^i, 2^(i+1))
+    static constexpr size_t GROWTH_BUCKETS = 64;
+
+    struct TypeUsage {
+        std::string type_name;
+        size_t element_size = 0;
+        size_t vectors = 0;
+        size_t used_bytes = 0;
+        size_t capacity_bytes = 0;
+        size_t growths = 0;
+
+        size_t WastedBytes() const noexcept {
+            return capacity_bytes - used_bytes;
+        }
+    };
+
+    std::array<size_t, UTILIZATION_BUCKETS> utilization{};
+    std::array<size_t, GROWTH_BUCKETS> growth{};
+    // Отсортированы по убыванию WastedBytes()
+    std::vector<TypeUsage> types;
+};
+
+class VectorUsageHook;
+
+class CapacityRegistry {
+public:
+    static CapacityRegistry& Instance() {
+        static CapacityRegistry registry;
+        return registry;
+    }
+
+    void Register(const VectorUsageHook* hook) {
+        std::lock_guard guard(mutex_);
+        live_.insert(hook);
+    }
+
+    void Unregister(const VectorUsageHook* hook) {
+        std::lock_guard guard(mutex_);
+        live_.erase(hook);
+    }
+
+    // Вызывается из noexcept-кода вектора, поэтому ошибки учёта молча игнорируются
+    void RecordGrowth(const std::type_info& type, size_t new_capacity) noexcept {
+        size_t bucket = 0;
+        while (bucket + 1 < CapacityReport::GROWTH_BUCKETS && (new_capacity >> (bucket + 1)) != 0) {
+            ++bucket;
+        }
+        try {
+            std::lock_guard guard(mutex_);
+            ++growth_[bucket];
+            auto& [type_info, growths] = growths_by_type_[std::type_index(type)];
+            type_info = &type;
+            ++growths;
+        }
+        catch (...) {
+        }
+    }
+
+    // Читает Size() и Capacity() живых векторов, поэтому вызывать следует,
+    // когда они не изменяются другими потоками
+    CapacityReport Snapshot() const;
+
+private:
+    CapacityRegistry() = default;
+
+    mutable std::mutex mutex_;
+    std::unordered_set<const VectorUsageHook*> live_;
+    std::array<size_t, CapacityReport::GROWTH_BUCKETS> growth_{};
+    std::unordered_map<std::type_index, std::pair<const std::type_info*, size_t>> growths_by_type_;
+};
+
+// Член Vector, регистрирующий его в реестре на время жизни.
+// Не копируется вместе с вектором: копия регистрируется заново своим конструктором
+class VectorUsageHook {
+public:
+    template <typename Owner>
+    explicit VectorUsageHook(const Owner& owner)
+        : owner_(&owner)
+        , type_(&typeid(std::remove_const_t<std::remove_reference_t<decltype(*owner.begin())>>))
+        , element_size_(sizeof(*owner.begin()))
+        , size_([](const void* p) {
+            return static_cast<const Owner*>(p)->Size();
+        })
+        , capacity_([](const void* p) {
+            return static_cast<const Owner*>(p)->Capacity();
+        }) {
+        CapacityRegistry::Instance().Register(this);
+    }
+
+    VectorUsageHook(const VectorUsageHook&) = delete;
+    VectorUsageHook& operator=(const VectorUsageHook&) = delete;
+
+    ~VectorUsageHook() {
+        CapacityRegistry::Instance().Unregister(this);
+    }
+
+    void OnGrowth(size_t new_capacity) const noexcept {
+        CapacityRegistry::Instance().RecordGrowth(*type_, new_capacity);
+    }
+
+    size_t Size() const {
+        return size_(owner_);
+    }
+
+    size_t Capacity() const {
+        return capacity_(owner_);
+    }
+
+    size_t ElementSize() const noexcept {
+        return element_size_;
+    }
+
+    const std::type_info& Type() const noexcept {
+        return *type_;
+    }
+
+private:
+    const void* owner_;
+    const std::type_info* type_;
+    size_t element_size_;
+    size_t (*size_)(const void*);
+    size_t (*capacity_)(const void*);
+};
+
+inline CapacityReport CapacityRegistry::Snapshot() const {
+    CapacityReport report;
+    std::map<std::type_index, CapacityReport::TypeUsage> by_type;
+    std::lock_guard guard(mutex_);
+    for (const VectorUsageHook* hook : live_) {
+        const size_t size = hook->Size();
+        const size_t capacity = hook->Capacity();
+        if (capacity != 0) {
+            ++report.utilization[size * (CapacityReport::UTILIZATION_BUCKETS - 1) / capacity];
+        }
+        auto& usage = by_type[std::type_index(hook->Type())];
+        if (usage.vectors == 0) {
+            usage.type_name = DemangleTypeName(hook->Type());
+        }
+        usage.element_size = hook->ElementSize();
+        ++usage.vectors;
+        usage.used_bytes += size * hook->ElementSize();
+        usage.capacity_bytes += capacity * hook->ElementSize();
+    }
+    report.growth = growth_;
+    for (const auto& [type, growths] : growths_by_type_) {
+        auto& usage = by_type[type];
+        usage.type_name = DemangleTypeName(*growths.first);
+        usage.growths = growths.second;
+    }
+    for (auto& [type, usage] : by_type) {
+        report.types.push_back(std::move(usage));
+    }
+    std::sort(report.types.begin(), report.types.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.WastedBytes() > rhs.WastedBytes();
+    });
+    return report;
+}
+
+inline void PrintCapacityReport(std::ostream& out, const CapacityReport& report, size_t top = 10) {
+    out << "Utilization of live vectors (Size / Capacity):" << std::endl;
+    for (size_t i = 0; i < CapacityReport::UTILIZATION_BUCKETS; ++i) {
+        if (i + 1 == CapacityReport::UTILIZATION_BUCKETS) {
+            out << "      100%";
+        }
+        else {
+            out << std::setw(4) << i * 10 << "-" << std::setw(3) << (i + 1) * 10 << "% ";
+        }
+        out << std::setw(10) << report.utilization[i] << std::endl;
+    }
+    out << "Growth steps by new capacity:" << std::endl;
+    for (size_t i = 0; i < CapacityReport::GROWTH_BUCKETS; ++i) {
+        if (report.growth[i] != 0) {
+            out << "  >= 2^" << std::setw(2) << std::left << i << std::right << std::setw(12) << report.growth[i]
+                << std::endl;
+        }
+    }
+    out << "Top wasted bytes by element type:" << std::endl;
+    for (size_t i = 0; i < std::min(top, report.types.size()); ++i) {
+        const auto& usage = report.types[i];
+        out << "  " << usage.type_name << ": wasted " << usage.WastedBytes() << " of " << usage.capacity_bytes
+            << " bytes in " << usage.vectors << " vector(s), " << usage.growths << " growth(s)" << std::endl;
+    }
+}
+
+inline void PrintCapacityReport(std::ostream& out = std::cerr, size_t top = 10) {
+    PrintCapacityReport(out, CapacityRegistry::Instance().Snapshot(), top);
+}
\ No newline at end of file
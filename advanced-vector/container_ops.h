@@ -0,0 +1,115 @@
+#pragma once
+#include "incremental_vector.h"
+#include "pregrowing_vector.h"
+#include "static_vector.h"
+#include "vector.h"
+
+#include <cstddef>
+#include <vector>
+
+// Единый интерфейс для Vector и std::vector, чтобы бенчмарки и воспроизведение трасс
+// были написаны один раз для обоих контейнеров
+namespace bench::ops {
+
+template <typename T>
+void PushBack(Vector<T>& v, const T& value) {
+    v.PushBack(value);
+}
+template <typename T>
+void PushBack(std::vector<T>& v, const T& value) {
+    v.push_back(value);
+}
+
+template <typename T, size_t N>
+void PushBack(StaticVector<T, N>& v, const T& value) {
+    v.PushBack(value);
+}
+
+template <typename T>
+void PushBack(IncrementalVector<T>& v, const T& value) {
+    v.PushBack(value);
+}
+
+template <typename T>
+void PushBack(PregrowingVector<T>& v, const T& value) {
+    v.PushBack(value);
+}
+
+template <typename T>
+void EmplaceBack(Vector<T>& v, const T& value) {
+    v.EmplaceBack(value);
+}
+template <typename T>
+void EmplaceBack(std::vector<T>& v, const T& value) {
+    v.emplace_back(value);
+}
+
+template <typename T>
+void EmplaceAt(Vector<T>& v, size_t index, const T& value) {
+    v.Emplace(v.cbegin() + index, value);
+}
+template <typename T>
+void EmplaceAt(std::vector<T>& v, size_t index, const T& value) {
+    v.emplace(v.cbegin() + index, value);
+}
+
+template <typename T>
+void EraseAt(Vector<T>& v, size_t index) {
+    v.Erase(v.cbegin() + index);
+}
+template <typename T>
+void EraseAt(std::vector<T>& v, size_t index) {
+    v.erase(v.cbegin() + index);
+}
+
+template <typename T>
+void Reserve(Vector<T>& v, size_t capacity) {
+    v.Reserve(capacity);
+}
+template <typename T>
+void Reserve(std::vector<T>& v, size_t capacity) {
+    v.reserve(capacity);
+}
+
+template <typename T>
+void Resize(Vector<T>& v, size_t size) {
+    v.Resize(size);
+}
+template <typename T>
+void Resize(std::vector<T>& v, size_t size) {
+    v.resize(size);
+}
+
+template <typename T>
+size_t Size(const Vector<T>& v) {
+    return v.Size();
+}
+template <typename T>
+size_t Size(const std::vector<T>& v) {
+    return v.size();
+}
+
+template <typename T, size_t N>
+size_t Size(const StaticVector<T, N>& v) {
+    return v.Size();
+}
+
+template <typename T>
+void PopBack(Vector<T>& v) {
+    v.PopBack();
+}
+template <typename T>
+void PopBack(std::vector<T>& v) {
+    v.pop_back();
+}
+
+template <typename T>
+void Swap(Vector<T>& lhs, Vector<T>& rhs) {
+    lhs.Swap(rhs);
+}
+template <typename T>
+void Swap(std::vector<T>& lhs, std::vector<T>& rhs) {
+    lhs.swap(rhs);
+}
+
+}  // namespace bench::ops
\ No newline at end of file
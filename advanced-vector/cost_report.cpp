@@ -0,0 +1,150 @@
+#include "counting_type.h"
+#include "vector.h"
+
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Выполняет набор операций над Vector<CountingType<T>> и сравнивает число копирований, перемещений,
+// разрушений и выделений памяти с теоретическим минимумом для каждой операции:
+//     cost_report [размер]
+// Превышение минимума помечается «!», например копирование при переносе элементов типа,
+// чей конструктор перемещения не объявлен noexcept
+
+namespace {
+
+    // Строка, конструктор перемещения которой не объявлен noexcept
+    struct LegacyString {
+        LegacyString() = default;
+        explicit LegacyString(std::string value)
+            : value(std::move(value)) {
+        }
+        LegacyString(const LegacyString&) = default;
+        LegacyString(LegacyString&& other)
+            : value(std::move(other.value)) {
+        }
+        LegacyString& operator=(const LegacyString&) = default;
+        LegacyString& operator=(LegacyString&& other) {
+            value = std::move(other.value);
+            return *this;
+        }
+
+        std::string value;
+    };
+
+    struct Cost {
+        size_t constructions = 0;
+        size_t copies = 0;
+        size_t moves = 0;
+        size_t destructions = 0;
+        size_t allocations = 0;
+    };
+
+    template <typename Element>
+    struct Operation {
+        std::string name;
+        // Готовит вектор, на котором выполняется операция; подготовка не учитывается
+        std::function<Vector<Element>()> prepare;
+        std::function<void(Vector<Element>&)> run;
+        Cost minimum;
+    };
+
+    template <typename Element>
+    Cost Measure(const Operation<Element>& operation) {
+        Vector<Element> v = operation.prepare();
+        Element::Reset();
+        ResetAllocationStats<Element>();
+        operation.run(v);
+        const OperationCounts counts = Element::Counts();
+        Cost cost;
+        cost.constructions = counts.constructions;
+        cost.copies = counts.Copies();
+        cost.moves = counts.Moves();
+        cost.destructions = counts.destructions;
+        cost.allocations = GetAllocationStats<Element>().allocations;
+        return cost;
+    }
+
+    std::string Cell(size_t actual, size_t minimum) {
+        std::ostringstream out;
+        out << actual << " (" << minimum << ")" << (actual > minimum ? "!" : "");
+        return out.str();
+    }
+
+    template <typename Element>
+    Vector<Element> Filled(size_t size, size_t capacity) {
+        Vector<Element> v;
+        v.Reserve(capacity);
+        for (size_t i = 0; i < size; ++i) {
+            v.EmplaceBack(std::to_string(i));
+        }
+        return v;
+    }
+
+    template <typename T>
+    void Report(std::string_view type_name, size_t n) {
+        using Element = CountingType<T>;
+        const auto full = [n] {
+            return Filled<Element>(n, n);
+        };
+        const auto spare = [n] {
+            return Filled<Element>(n, n * 2);
+        };
+        const Element value(std::string("value"));
+
+        const std::vector<Operation<Element>> operations = {
+            {"Reserve(2n)", full, [n](auto& v) { v.Reserve(n * 2); }, {0, 0, n, n, 1}},
+            {"Resize(2n)", full, [n](auto& v) { v.Resize(n * 2); }, {n, 0, n, n, 1}},
+            {"PushBack(const&), full", full, [&value](auto& v) { v.PushBack(value); }, {0, 1, n, n, 1}},
+            {"PushBack(&&), full", full, [](auto& v) { v.PushBack(Element(std::string("x"))); }, {1, 0, n + 1, n + 1, 1}},
+            {"EmplaceBack, spare", spare, [](auto& v) { v.EmplaceBack(std::string("x")); }, {1, 0, 0, 0, 0}},
+            // Vector строит новый элемент во временном объекте до сдвига, потому что аргументы могут ссылаться
+            // на его элементы, и сверх минимума тратит одно перемещение и одно разрушение
+            {"Emplace(begin), spare", spare, [](auto& v) { v.Emplace(v.begin(), std::string("x")); }, {1, 0, n, 0, 0}},
+            {"Emplace(begin), full", full, [](auto& v) { v.Emplace(v.begin(), std::string("x")); }, {1, 0, n, n, 1}},
+            {"Erase(begin)", full, [](auto& v) { v.Erase(v.begin()); }, {0, 0, n - 1, 1, 0}},
+            {"Copy construction", full, [](auto& v) { Vector<Element> copy(v); }, {0, n, 0, n, 1}},
+            {"Copy assignment", full, [](auto& v) { Vector<Element> copy; copy = v; }, {0, n, 0, n, 1}},
+            {"Move construction", full, [](auto& v) { Vector<Element> moved(std::move(v)); v.Swap(moved); }, {0, 0, 0, 0, 0}},
+        };
+
+        std::cout << type_name << ", n = " << n << '\n'
+                  << std::left << std::setw(26) << "Operation" << std::right << std::setw(16) << "Constructions"
+                  << std::setw(16) << "Copies" << std::setw(16) << "Moves" << std::setw(16) << "Destructions"
+                  << std::setw(14) << "Allocations" << '\n'
+                  << std::string(104, '-') << std::endl;
+        for (const auto& operation : operations) {
+            const Cost cost = Measure(operation);
+            const Cost& min = operation.minimum;
+            std::cout << std::left << std::setw(26) << operation.name << std::right                   //
+                      << std::setw(16) << Cell(cost.constructions, min.constructions)                  //
+                      << std::setw(16) << Cell(cost.copies, min.copies)                                //
+                      << std::setw(16) << Cell(cost.moves, min.moves)                                  //
+                      << std::setw(16) << Cell(cost.destructions, min.destructions)                    //
+                      << std::setw(14) << Cell(cost.allocations, min.allocations) << std::endl;
+        }
+        std::cout << std::endl;
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    try {
+        const size_t n = argc > 1 ? std::stoull(argv[1]) : 1000;
+        if (n == 0) {
+            std::cerr << "Size must be positive" << std::endl;
+            return 1;
+        }
+        std::cout << "Actual count (theoretical minimum), ! marks excess" << std::endl << std::endl;
+        Report<std::string>("CountingType<std::string>", n);
+        Report<LegacyString>("CountingType<LegacyString> (move ctor is not noexcept)", n);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
\ No newline at end of file
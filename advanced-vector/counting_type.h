@@ -0,0 +1,111 @@
+#pragma once
+#include "allocation_stats.h"
+
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Количество вызовов специальных функций-членов
+struct OperationCounts {
+    size_t constructions = 0;     // конструкторы по умолчанию и из аргументов T
+    size_t copy_constructions = 0;
+    size_t move_constructions = 0;
+    size_t copy_assignments = 0;
+    size_t move_assignments = 0;
+    size_t destructions = 0;
+
+    size_t Copies() const noexcept {
+        return copy_constructions + copy_assignments;
+    }
+
+    size_t Moves() const noexcept {
+        return move_constructions + move_assignments;
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const OperationCounts& counts) {
+    using namespace std::literals;
+    return out << "Ctors: "sv << counts.constructions                  //
+               << ", Copy ctors: "sv << counts.copy_constructions      //
+               << ", Move ctors: "sv << counts.move_constructions      //
+               << ", Copy assignments: "sv << counts.copy_assignments  //
+               << ", Move assignments: "sv << counts.move_assignments  //
+               << ", Dtors: "sv << counts.destructions;
+}
+
+// Обёртка над T, считающая копирования, перемещения и разрушения. Спецификации noexcept
+// повторяют спецификации T, поэтому Vector выбирает для обёртки тот же способ переноса элементов
+// (перемещение или копирование), что и для самого T.
+// Счётчики свои для каждого T и, как у Obj и C в тестах, не защищены от гонок
+template <typename T>
+class CountingType {
+public:
+    CountingType() noexcept(std::is_nothrow_default_constructible_v<T>)
+        : value_() {
+        ++counts_.constructions;
+    }
+
+    template <typename... Args,
+              std::enable_if_t<std::is_constructible_v<T, Args&&...>
+                                   && !(sizeof...(Args) == 1 && (std::is_same_v<std::decay_t<Args>, CountingType> && ...)),
+                               int> = 0>
+    explicit CountingType(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args&&...>)
+        : value_(std::forward<Args>(args)...) {
+        ++counts_.constructions;
+    }
+
+    CountingType(const CountingType& other) noexcept(std::is_nothrow_copy_constructible_v<T>)
+        : value_(other.value_) {
+        ++counts_.copy_constructions;
+    }
+
+    CountingType(CountingType&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : value_(std::move(other.value_)) {
+        ++counts_.move_constructions;
+    }
+
+    CountingType& operator=(const CountingType& rhs) noexcept(std::is_nothrow_copy_assignable_v<T>) {
+        value_ = rhs.value_;
+        ++counts_.copy_assignments;
+        return *this;
+    }
+
+    CountingType& operator=(CountingType&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        value_ = std::move(rhs.value_);
+        ++counts_.move_assignments;
+        return *this;
+    }
+
+    ~CountingType() {
+        ++counts_.destructions;
+    }
+
+    T& Get() noexcept {
+        return value_;
+    }
+
+    const T& Get() const noexcept {
+        return value_;
+    }
+
+    static OperationCounts Counts() noexcept {
+        return counts_;
+    }
+
+    static void Reset() noexcept {
+        counts_ = {};
+    }
+
+private:
+    T value_;
+
+    static inline OperationCounts counts_;
+};
+
+// Векторы CountingType всегда ведут учёт выделений памяти
+template <typename T>
+struct AllocationPolicy<CountingType<T>> {
+    using type = TrackAllocations<CountingType<T>>;
+};
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+#include "pipeline.h"
+#include "vector.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Уничтожение больших векторов в фоновом потоке. Разрушение вектора из 1e8 строк — это 1e8 вызовов
+// деструктора и освобождений памяти, и вызывающий поток стоит на нём десятки миллисекунд.
+// Reclaimer забирает буфер перемещением за O(1) и разрушает элементы и освобождает память в своём потоке.
+// Очередь ограничена: если фоновый поток не успевает, Destroy ждёт места, и несобранный мусор
+// не растёт без предела
+
+// Векторы меньше этого размера разрушаются сразу: передача в другой поток стоит дороже
+inline constexpr size_t DEFERRED_DESTROY_MIN_BYTES = 64 * 1024;
+
+namespace detail {
+
+    struct Garbage {
+        virtual ~Garbage() = default;
+    };
+
+    template <typename T>
+    struct VectorGarbage : Garbage {
+        explicit VectorGarbage(Vector<T>&& v) noexcept
+            : vector(std::move(v)) {
+        }
+
+        Vector<T> vector;
+    };
+
+}  // namespace detail
+
+class Reclaimer {
+public:
+    static constexpr size_t DEFAULT_QUEUE_CAPACITY = 64;
+
+    explicit Reclaimer(size_t queue_capacity = DEFAULT_QUEUE_CAPACITY)
+        : queue_(queue_capacity)
+        , thread_([this] {
+            Work();
+        }) {
+    }
+
+    Reclaimer(const Reclaimer&) = delete;
+    Reclaimer& operator=(const Reclaimer&) = delete;
+
+    // Разрушает всё, что осталось в очереди
+    ~Reclaimer() {
+        queue_.Close();
+        thread_.join();
+    }
+
+    // Забирает элементы и память v, оставляя его пустым, и разрушает их в фоновом потоке.
+    // Если очередь заполнена, ждёт, пока фоновый поток её разберёт
+    template <typename T>
+    void Destroy(Vector<T>&& v) {
+        if (v.Capacity() * sizeof(T) < DEFERRED_DESTROY_MIN_BYTES) {
+            Vector<T> dropped(std::move(v));
+            return;
+        }
+        auto garbage = std::make_unique<detail::VectorGarbage<T>>(std::move(v));
+        {
+            std::lock_guard guard(mutex_);
+            ++submitted_;
+        }
+        if (!queue_.Push(std::move(garbage))) {
+            // Очередь уже закрыта, и вектор разрушен в Push
+            Complete();
+        }
+    }
+
+    // Ждёт разрушения всего, что было передано в Destroy до вызова. Очередь разбирается по порядку,
+    // поэтому достаточно дождаться submitted_ разрушений на момент вызова: среди первых submitted_
+    // разрушенных окажется всё, что попало в очередь раньше. Destroy, вызванные позже, не задерживают Flush
+    void Flush() {
+        std::unique_lock lock(mutex_);
+        const uint64_t ticket = submitted_;
+        done_.wait(lock, [this, ticket] {
+            return completed_ >= ticket;
+        });
+    }
+
+private:
+    void Work() {
+        std::unique_ptr<detail::Garbage> garbage;
+        while (queue_.Pop(garbage)) {
+            garbage.reset();
+            Complete();
+        }
+    }
+
+    void Complete() {
+        std::lock_guard guard(mutex_);
+        ++completed_;
+        done_.notify_all();
+    }
+
+    BoundedQueue<std::unique_ptr<detail::Garbage>> queue_;
+    std::mutex mutex_;
+    std::condition_variable done_;
+    // Сколько векторов передано в Destroy и сколько из них уже разрушено
+    uint64_t submitted_ = 0;
+    uint64_t completed_ = 0;
+    std::thread thread_;
+};
+
+// Общий фоновый поток разрушения, создаётся при первом обращении
+inline Reclaimer& DefaultReclaimer() {
+    static Reclaimer reclaimer;
+    return reclaimer;
+}
+
+// Разрушает v в DefaultReclaimer, см. Reclaimer::Destroy
+template <typename T>
+void DeferredDestroy(Vector<T>&& v) {
+    DefaultReclaimer().Destroy(std::move(v));
+}
\ No newline at end of file
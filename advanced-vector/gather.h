@@ -0,0 +1,383 @@
+#pragma once
+#include "parallel.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// Программная предвыборка для обходов с произвольным доступом к памяти: по вектору указателей
+// или по вектору индексов. Аппаратный префетчер угадывает только последовательный доступ,
+// поэтому каждая такая операция чтения ждёт память целиком. Запрос данных на distance шагов вперёд
+// позволяет ожиданиям перекрываться. Оптимальное расстояние зависит от задержки памяти и работы
+// на шаг; DEFAULT_PREFETCH_DISTANCE подходит для коротких тел циклов
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ADVANCED_VECTOR_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define ADVANCED_VECTOR_PREFETCH(address) ((void)(address))
+#endif
+
+inline constexpr size_t DEFAULT_PREFETCH_DISTANCE = 32;
+
+namespace detail {
+
+    // Адрес, который понадобится при обработке элемента: для указателя — объект, на который он указывает
+    template <typename T>
+    const void* PrefetchAddress(const T& item) noexcept {
+        if constexpr (std::is_pointer_v<T>) {
+            return item;
+        }
+        else {
+            return std::addressof(item);
+        }
+    }
+
+    // Число 4-байтных элементов в одной инструкции gather, 0 — если таких инструкций нет
+#if defined(__AVX512F__)
+    inline constexpr size_t SIMD_GATHER_WIDTH = 16;
+#elif defined(__AVX2__)
+    inline constexpr size_t SIMD_GATHER_WIDTH = 8;
+#else
+    inline constexpr size_t SIMD_GATHER_WIDTH = 0;
+#endif
+
+    // Инструкции gather читают 4-байтные элементы по 32-битным знаковым индексам
+    template <typename T, typename Index>
+    inline constexpr bool SIMD_GATHER = SIMD_GATHER_WIDTH > 0 && sizeof(T) == 4 && std::is_trivially_copyable_v<T>
+                                        && std::is_integral_v<Index> && sizeof(Index) == 4;
+
+    // out[i] = items[index[i]] для i из [from, to). Предвыборка не заходит за size — число всех индексов
+    template <typename T, typename Index>
+    void GatherRange(const T* items, [[maybe_unused]] size_t items_size, const Index* index, T* out, size_t from,
+                     size_t to, size_t size, size_t distance) {
+        size_t i = from;
+#if defined(__AVX512F__) || defined(__AVX2__)
+        if constexpr (SIMD_GATHER<T, Index>) {
+            if (items_size <= INT32_MAX) {
+                constexpr size_t WIDTH = SIMD_GATHER_WIDTH;
+                for (; i + WIDTH <= to; i += WIDTH) {
+                    if (i + distance + WIDTH <= size) {
+                        for (size_t k = 0; k < WIDTH; ++k) {
+                            ADVANCED_VECTOR_PREFETCH(items + index[i + distance + k]);
+                        }
+                    }
+                    for (size_t k = 0; k < WIDTH; ++k) {
+                        assert(static_cast<size_t>(index[i + k]) < items_size);
+                    }
+                    // Варианты с маской и нулевым исходным значением: у варианта без маски GCC берёт исходное
+                    // значение из неинициализированного регистра и предупреждает -Wmaybe-uninitialized
+#if defined(__AVX512F__)
+                    const __m512i lanes = _mm512_loadu_si512(index + i);
+                    _mm512_storeu_si512(out + i, _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, lanes, items, 4));
+#else
+                    const __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(index + i));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                                        _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int*>(items),
+                                                                    lanes, _mm256_set1_epi32(-1), 4));
+#endif
+                }
+            }
+        }
+#endif
+        const size_t prefetched = std::min(to, size > distance ? size - distance : 0);
+        for (; i < prefetched; ++i) {
+            ADVANCED_VECTOR_PREFETCH(items + index[i + distance]);
+            assert(static_cast<size_t>(index[i]) < items_size);
+            out[i] = items[index[i]];
+        }
+        for (; i < to; ++i) {
+            assert(static_cast<size_t>(index[i]) < items_size);
+            out[i] = items[index[i]];
+        }
+    }
+
+    // items[index[i]] += values[i] для i из [from, to). Пара gather и scatter AVX-512 с проверкой конфликтов
+    // индексов здесь медленнее скалярного цикла, поэтому сложение остаётся скалярным
+    template <typename T, typename Index>
+    void ScatterAddRange(T* items, [[maybe_unused]] size_t items_size, const Index* index, const T* values,
+                         size_t from, size_t to, size_t distance) {
+        size_t i = from;
+        const size_t prefetched = to - i > distance ? to - distance : i;
+        for (; i < prefetched; ++i) {
+            ADVANCED_VECTOR_PREFETCH(items + index[i + distance]);
+            assert(static_cast<size_t>(index[i]) < items_size);
+            items[index[i]] += values[i];
+        }
+        for (; i < to; ++i) {
+            assert(static_cast<size_t>(index[i]) < items_size);
+            items[index[i]] += values[i];
+        }
+    }
+
+    // Участок data, который ScatterAddGrouped обновляет за раз: помещается в L2
+    inline constexpr size_t SCATTER_GROUP_BYTES = 256 * 1024;
+
+}  // namespace detail
+
+// Итератор по непрерывному диапазону, который при каждом шаге запрашивает данные элемента,
+// отстоящего на distance позиций вперёд (для указателей — объект, на который указывает элемент).
+// За конец диапазона предвыборка не заходит
+template <typename T>
+class PrefetchingIterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    PrefetchingIterator() = default;
+
+    PrefetchingIterator(T* item, T* end, size_t distance = DEFAULT_PREFETCH_DISTANCE) noexcept
+        : item_(item)
+        , end_(end)
+        , distance_(distance) {
+        // Первые distance элементов запрашиваются сразу, дальше — по одному на шаг
+        for (size_t i = 1; i <= distance_ && item_ + i < end_; ++i) {
+            ADVANCED_VECTOR_PREFETCH(detail::PrefetchAddress(item_[i]));
+        }
+    }
+
+    T& operator*() const noexcept {
+        return *item_;
+    }
+
+    T* operator->() const noexcept {
+        return item_;
+    }
+
+    PrefetchingIterator& operator++() noexcept {
+        ++item_;
+        if (static_cast<size_t>(end_ - item_) > distance_) {
+            ADVANCED_VECTOR_PREFETCH(detail::PrefetchAddress(item_[distance_]));
+        }
+        return *this;
+    }
+
+    PrefetchingIterator operator++(int) noexcept {
+        PrefetchingIterator old = *this;
+        ++*this;
+        return old;
+    }
+
+    bool operator==(const PrefetchingIterator& other) const noexcept {
+        return item_ == other.item_;
+    }
+    bool operator!=(const PrefetchingIterator& other) const noexcept {
+        return item_ != other.item_;
+    }
+
+private:
+    T* item_ = nullptr;
+    T* end_ = nullptr;
+    size_t distance_ = 0;
+};
+
+// Диапазон для range-based for с предвыборкой:
+//     for (Node* node : Prefetching(nodes)) { ... }
+template <typename T>
+class PrefetchingRange {
+public:
+    PrefetchingRange(T* begin, T* end, size_t distance) noexcept
+        : begin_(begin, end, distance)
+        , end_(end, end, distance) {
+    }
+
+    PrefetchingIterator<T> begin() const noexcept {
+        return begin_;
+    }
+    PrefetchingIterator<T> end() const noexcept {
+        return end_;
+    }
+
+private:
+    PrefetchingIterator<T> begin_;
+    PrefetchingIterator<T> end_;
+};
+
+template <typename T>
+PrefetchingRange<T> Prefetching(Vector<T>& v, size_t distance = DEFAULT_PREFETCH_DISTANCE) noexcept {
+    return PrefetchingRange<T>(v.begin(), v.end(), distance);
+}
+
+template <typename T>
+PrefetchingRange<const T> Prefetching(const Vector<T>& v, size_t distance = DEFAULT_PREFETCH_DISTANCE) noexcept {
+    return PrefetchingRange<const T>(v.begin(), v.end(), distance);
+}
+
+// out[i] = data[indices[i]] для всех i. Прежнее содержимое out заменяется, а его память используется повторно.
+// Для 4-байтных элементов и индексов при сборке с AVX2 или AVX-512 читает по 8 или 16 элементов
+// одной инструкцией gather. out не должен совпадать с data
+template <typename T, typename Index>
+void Gather(const Vector<T>& data, const Vector<Index>& indices, Vector<T>& out,
+            size_t distance = DEFAULT_PREFETCH_DISTANCE) {
+    static_assert(std::is_integral_v<Index>, "Gather needs integral indices");
+    assert(&out != &data);
+    const size_t size = indices.Size();
+    const T* items = data.begin();
+    const Index* index = indices.begin();
+    if constexpr (detail::SIMD_GATHER<T, Index>) {
+        out.Resize(size);
+        detail::GatherRange(items, data.Size(), index, out.begin(), 0, size, size, distance);
+        return;
+    }
+    out.Clear();
+    out.Reserve(size);
+    // Основной цикл не проверяет границу предвыборки, она вынесена в отдельный хвост
+    const size_t prefetched = size > distance ? size - distance : 0;
+    size_t i = 0;
+    for (; i < prefetched; ++i) {
+        ADVANCED_VECTOR_PREFETCH(items + index[i + distance]);
+        assert(static_cast<size_t>(index[i]) < data.Size());
+        out.EmplaceBack(items[index[i]]);
+    }
+    for (; i < size; ++i) {
+        assert(static_cast<size_t>(index[i]) < data.Size());
+        out.EmplaceBack(items[index[i]]);
+    }
+}
+
+// Gather, в котором out делится на участки между threads потоками (0 — по числу ядер).
+// Элементы out сначала создаются конструктором по умолчанию, затем перезаписываются
+template <typename T, typename Index>
+void ParallelGather(const Vector<T>& data, const Vector<Index>& indices, Vector<T>& out, size_t threads = 0,
+                    size_t distance = DEFAULT_PREFETCH_DISTANCE) {
+    static_assert(std::is_integral_v<Index>, "Gather needs integral indices");
+    assert(&out != &data);
+    const size_t size = indices.Size();
+    out.Resize(size);
+    ParallelFor(
+        0, size,
+        [&](size_t from, size_t to) {
+            detail::GatherRange(data.begin(), data.Size(), indices.begin(), out.begin(), from, to, size, distance);
+        },
+        threads);
+}
+
+// data[indices[i]] += values[i] для всех i по порядку, с предвыборкой изменяемых элементов data
+template <typename T, typename Index>
+void ScatterAdd(Vector<T>& data, const Vector<Index>& indices, const Vector<T>& values,
+                size_t distance = DEFAULT_PREFETCH_DISTANCE) {
+    static_assert(std::is_integral_v<Index>, "ScatterAdd needs integral indices");
+    assert(indices.Size() == values.Size() && &values != &data);
+    detail::ScatterAddRange(data.begin(), data.Size(), indices.begin(), values.begin(), 0, indices.Size(), distance);
+}
+
+// Рабочая память ScatterAddGrouped и ParallelScatterAdd. Её повторное использование между вызовами избавляет
+// от выделения и первого заполнения страниц под копию всех слагаемых
+template <typename T, typename Index>
+struct ScatterBuffer {
+    Vector<Index> indices;
+    Vector<T> values;
+    Vector<size_t> offsets;
+};
+
+namespace detail {
+
+    // Устойчиво раскладывает слагаемые сортировкой подсчётом по группам: в группу g попадают индексы
+    // из [g << shift, (g + 1) << shift). После этого слагаемые группы g лежат в buffer.indices
+    // и buffer.values на позициях [buffer.offsets[g], buffer.offsets[g + 1])
+    template <typename T, typename Index>
+    void GroupByBlock(size_t data_size, const Vector<Index>& indices, const Vector<T>& values, size_t shift,
+                      ScatterBuffer<T, Index>& buffer) {
+        const size_t size = indices.Size();
+        const Index* index = indices.begin();
+        // offsets[g + 2] — число слагаемых группы g, после суммирования offsets[g + 1] — начало группы g,
+        // а после раскладки — её конец
+        Vector<size_t>& offsets = buffer.offsets;
+        offsets.Clear();
+        offsets.Resize((data_size >> shift) + 3);
+        for (size_t i = 0; i < size; ++i) {
+            assert(static_cast<size_t>(index[i]) < data_size);
+            ++offsets[(static_cast<size_t>(index[i]) >> shift) + 2];
+        }
+        for (size_t g = 1; g < offsets.Size(); ++g) {
+            offsets[g] += offsets[g - 1];
+        }
+        buffer.indices.Resize(size);
+        buffer.values.Resize(size);
+        for (size_t i = 0; i < size; ++i) {
+            const size_t position = offsets[(static_cast<size_t>(index[i]) >> shift) + 1]++;
+            buffer.indices[position] = index[i];
+            buffer.values[position] = values[i];
+        }
+    }
+
+}  // namespace detail
+
+// ScatterAdd для data намного больше кэша. Слагаемые сначала раскладываются сортировкой подсчётом по группам:
+// в группу попадают индексы одного участка data размером SCATTER_GROUP_BYTES. Затем группы применяются
+// по очереди, и случайные обращения каждой группы не выходят за участок, уже лежащий в кэше. Сортировка
+// устойчива, поэтому каждый элемент data получает слагаемые в том же порядке, что и в ScatterAdd
+template <typename T, typename Index>
+void ScatterAddGrouped(Vector<T>& data, const Vector<Index>& indices, const Vector<T>& values,
+                       ScatterBuffer<T, Index>& buffer, size_t distance = DEFAULT_PREFETCH_DISTANCE) {
+    static_assert(std::is_integral_v<Index>, "ScatterAdd needs integral indices");
+    assert(indices.Size() == values.Size() && &values != &data);
+    const size_t shift = std::bit_width(std::max<size_t>(detail::SCATTER_GROUP_BYTES / sizeof(T), 2)) - 1;
+    if ((data.Size() >> shift) == 0) {
+        ScatterAdd(data, indices, values, distance);
+        return;
+    }
+    detail::GroupByBlock(data.Size(), indices, values, shift, buffer);
+    detail::ScatterAddRange(data.begin(), data.Size(), buffer.indices.begin(), buffer.values.begin(), 0, indices.Size(), distance);
+}
+
+template <typename T, typename Index>
+void ScatterAddGrouped(Vector<T>& data, const Vector<Index>& indices, const Vector<T>& values,
+                       size_t distance = DEFAULT_PREFETCH_DISTANCE) {
+    ScatterBuffer<T, Index> buffer;
+    ScatterAddGrouped(data, indices, values, buffer, distance);
+}
+
+// ScatterAdd, в котором data делится на участки между threads потоками (0 — по числу ядер). Слагаемые один раз
+// раскладываются по участкам, как в ScatterAddGrouped, и каждый поток проходит только слагаемые своих участков,
+// поэтому потокам не нужны ни блокировки, ни атомарные операции. Раскладка устойчива, и каждый элемент
+// получает слагаемые в том же порядке, что и в ScatterAdd
+template <typename T, typename Index>
+void ParallelScatterAdd(Vector<T>& data, const Vector<Index>& indices, const Vector<T>& values,
+                        ScatterBuffer<T, Index>& buffer, size_t threads = 0) {
+    static_assert(std::is_integral_v<Index>, "ScatterAdd needs integral indices");
+    assert(indices.Size() == values.Size() && &values != &data);
+    // Как в ParallelFor, потоку достаётся не меньше 4096 элементов, а одному потоку раскладка не нужна
+    if (threads == 0) {
+        threads = DefaultThreadCount();
+    }
+    threads = std::clamp<size_t>(data.Size() / 4096, 1, threads);
+    if (threads == 1) {
+        ScatterAdd(data, indices, values);
+        return;
+    }
+    // Участков хотя бы по одному на поток, но не меньше групп ScatterAddGrouped, где это возможно:
+    // по меньшему числу участков слагаемые раскладываются быстрее
+    const size_t group_shift = std::bit_width(std::max<size_t>(detail::SCATTER_GROUP_BYTES / sizeof(T), 2)) - 1;
+    const size_t shift = std::min<size_t>(group_shift, std::bit_width(data.Size() / threads) - 1);
+    detail::GroupByBlock(data.Size(), indices, values, shift, buffer);
+    T* items = data.begin();
+    const size_t items_size = data.Size();
+    const Index* index = buffer.indices.begin();
+    const T* value = buffer.values.begin();
+    const size_t* offsets = buffer.offsets.begin();
+    ParallelFor(
+        0, (items_size >> shift) + 1,
+        [=](size_t from, size_t to) {
+            detail::ScatterAddRange(items, items_size, index, value, offsets[from], offsets[to],
+                                    DEFAULT_PREFETCH_DISTANCE);
+        },
+        threads, 1);
+}
+
+template <typename T, typename Index>
+void ParallelScatterAdd(Vector<T>& data, const Vector<Index>& indices, const Vector<T>& values, size_t threads = 0) {
+    ScatterBuffer<T, Index> buffer;
+    ParallelScatterAdd(data, indices, values, buffer, threads);
+}
\ No newline at end of file
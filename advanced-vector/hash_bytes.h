@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Быстрый некриптографический хеш непрерывного блока байтов по схеме wyhash: блок читается
+// 8-байтными словами, каждая пара слов перемешивается одним умножением 64 x 64 -> 128 бит.
+// Хеш зависит от порядка байтов платформы и не подходит для хранения на диске или передачи по сети
+
+namespace detail {
+
+    inline constexpr uint64_t HASH_SECRET[4] = {
+        0xa0761d6478bd642full,
+        0xe7037ed1a0b428dbull,
+        0x8ebc6af09c88c6e3ull,
+        0x589965cc75374cc3ull,
+    };
+
+    // Заменяет a и b младшей и старшей половинами их произведения
+    inline void HashMultiply(uint64_t& a, uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+        a = static_cast<uint64_t>(product);
+        b = static_cast<uint64_t>(product >> 64);
+#else
+        const uint64_t a_low = a & 0xffffffffu;
+        const uint64_t a_high = a >> 32;
+        const uint64_t b_low = b & 0xffffffffu;
+        const uint64_t b_high = b >> 32;
+        const uint64_t low_low = a_low * b_low;
+        const uint64_t middle = (low_low >> 32) + (a_high * b_low & 0xffffffffu) + a_low * b_high;
+        a = (middle << 32) | (low_low & 0xffffffffu);
+        b = a_high * b_high + (a_high * b_low >> 32) + (middle >> 32);
+#endif
+    }
+
+    inline uint64_t HashMix(uint64_t a, uint64_t b) noexcept {
+        HashMultiply(a, b);
+        return a ^ b;
+    }
+
+    inline uint64_t HashRead8(const unsigned char* bytes) noexcept {
+        uint64_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    inline uint64_t HashRead4(const unsigned char* bytes) noexcept {
+        uint32_t word;
+        std::memcpy(&word, bytes, sizeof(word));
+        return word;
+    }
+
+    inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = 0) noexcept {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        seed ^= HashMix(seed ^ HASH_SECRET[0], HASH_SECRET[1]);
+        uint64_t a = 0;
+        uint64_t b = 0;
+        if (size <= 16) {
+            if (size >= 4) {
+                // Два перекрывающихся чтения по 4 байта с каждого края покрывают блоки от 4 до 16 байтов
+                const size_t shift = (size >> 3) << 2;
+                a = (HashRead4(bytes) << 32) | HashRead4(bytes + shift);
+                b = (HashRead4(bytes + size - 4) << 32) | HashRead4(bytes + size - 4 - shift);
+            }
+            else if (size > 0) {
+                a = (uint64_t(bytes[0]) << 16) | (uint64_t(bytes[size >> 1]) << 8) | bytes[size - 1];
+            }
+        }
+        else {
+            size_t rest = size;
+            if (rest > 48) {
+                // Три независимые цепочки, чтобы умножения выполнялись параллельно
+                uint64_t seed1 = seed;
+                uint64_t seed2 = seed;
+                do {
+                    seed = HashMix(HashRead8(bytes) ^ HASH_SECRET[1], HashRead8(bytes + 8) ^ seed);
+                    seed1 = HashMix(HashRead8(bytes + 16) ^ HASH_SECRET[2], HashRead8(bytes + 24) ^ seed1);
+                    seed2 = HashMix(HashRead8(bytes + 32) ^ HASH_SECRET[3], HashRead8(bytes + 40) ^ seed2);
+                    bytes += 48;
+                    rest -= 48;
+                } while (rest > 48);
+                seed ^= seed1 ^ seed2;
+            }
+            while (rest > 16) {
+                seed = HashMix(HashRead8(bytes) ^ HASH_SECRET[1], HashRead8(bytes + 8) ^ seed);
+                bytes += 16;
+                rest -= 16;
+            }
+            a = HashRead8(bytes + rest - 16);
+            b = HashRead8(bytes + rest - 8);
+        }
+        a ^= HASH_SECRET[1];
+        b ^= seed;
+        HashMultiply(a, b);
+        return HashMix(a ^ HASH_SECRET[0] ^ size, b ^ HASH_SECRET[1]);
+    }
+
+    // Добавляет к накопленному хешу хеш очередного элемента
+    inline uint64_t HashCombine(uint64_t hash, uint64_t item) noexcept {
+        return HashMix(hash ^ HASH_SECRET[0], item ^ HASH_SECRET[1]);
+    }
+
+}  // namespace detail
\ No newline at end of file
@@ -0,0 +1,189 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Вектор с постепенным ростом для кода с ограничением на задержку одной операции. Когда ёмкость
+// исчерпана, выделяется вдвое больший блок, но элементы в него не переносятся сразу: каждая следующая
+// вставка или удаление переносит не больше migration_step старых элементов. Пока перенос не закончен,
+// operator[] выбирает блок по индексу, поэтому ни одна операция не переносит весь вектор.
+// При шаге не меньше 1 перенос заканчивается раньше, чем заполнится новый блок.
+// Освобождение старого блока остаётся на операции, закончившей перенос: для блоков в сотни мегабайт
+// оно стоит заметно дороже шага переноса
+template <typename T>
+class IncrementalVector {
+    // Перенос между вставками не может откатиться, если перемещение бросит исключение
+    static_assert(std::is_nothrow_move_constructible_v<T>, "IncrementalVector requires a nothrow move constructor");
+
+public:
+    static constexpr size_t DEFAULT_MIGRATION_STEP = 4;
+
+    explicit IncrementalVector(size_t migration_step = DEFAULT_MIGRATION_STEP) noexcept
+        : migration_step_(std::max<size_t>(migration_step, 1)) {
+    }
+
+    IncrementalVector(const IncrementalVector&) = delete;
+    IncrementalVector& operator=(const IncrementalVector&) = delete;
+
+    IncrementalVector(IncrementalVector&& other) noexcept
+        : data_(std::move(other.data_))
+        , old_(std::move(other.old_))
+        , size_(std::exchange(other.size_, 0))
+        , old_size_(std::exchange(other.old_size_, 0))
+        , migrated_(std::exchange(other.migrated_, 0))
+        , migration_step_(other.migration_step_) {
+    }
+
+    IncrementalVector& operator=(IncrementalVector&& rhs) noexcept {
+        if (this != &rhs) {
+            Clear();
+            data_ = std::move(rhs.data_);
+            old_ = std::move(rhs.old_);
+            size_ = std::exchange(rhs.size_, 0);
+            old_size_ = std::exchange(rhs.old_size_, 0);
+            migrated_ = std::exchange(rhs.migrated_, 0);
+            migration_step_ = rhs.migration_step_;
+        }
+        return *this;
+    }
+
+    ~IncrementalVector() {
+        Clear();
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Идёт ли перенос элементов из старого блока
+    bool IsMigrating() const noexcept {
+        return migrated_ < old_size_;
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        return const_cast<IncrementalVector&>(*this)[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        // Вне переноса old_size_ == migrated_ == 0, и проверка не выполняется
+        if (index < old_size_ && index >= migrated_) {
+            return old_[index];
+        }
+        return data_[index];
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        if (size_ == Capacity()) {
+            // Шаг переноса не меньше 1, поэтому к заполнению блока прошлый перенос уже закончен
+            assert(!IsMigrating());
+            RawMemory<T> new_data(size_ == 0 ? 1 : size_ * 2);
+            std::construct_at(new_data + size_, std::forward<Args>(args)...);
+            old_ = std::move(data_);
+            data_ = std::move(new_data);
+            old_size_ = size_;
+            migrated_ = 0;
+        }
+        else {
+            std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        }
+        T& item = data_[size_++];
+        Migrate(migration_step_);
+        return item;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(&(*this)[size_ - 1]);
+        --size_;
+        if (size_ < old_size_) {
+            old_size_ = std::max(size_, migrated_);
+        }
+        Migrate(migration_step_);
+    }
+
+    // Переносит все оставшиеся элементы; после этого элементы лежат в одном блоке подряд
+    void FinishMigration() noexcept {
+        Migrate(old_size_ - migrated_);
+    }
+
+    // Заканчивает перенос и при необходимости переносит элементы в блок на capacity элементов сразу
+    void Reserve(size_t capacity) {
+        FinishMigration();
+        if (capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T> new_data(capacity);
+        detail::UninitializedMoveN(data_.GetAddress(), size_, new_data.GetAddress());
+        std::destroy_n(data_.GetAddress(), size_);
+        data_ = std::move(new_data);
+    }
+
+    // Уничтожает все элементы, сохраняя новый блок
+    void Clear() noexcept {
+        FinishMigration();
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    // Вызывает f для каждого элемента по порядку. Участки блоков обходятся подряд, без выбора блока
+    // на каждом элементе, как в operator[]
+    template <typename F>
+    void ForEach(F f) const {
+        const T* data = data_.GetAddress();
+        for (size_t i = 0; i < migrated_; ++i) {
+            f(data[i]);
+        }
+        for (size_t i = migrated_; i < old_size_; ++i) {
+            f(old_[i]);
+        }
+        for (size_t i = old_size_; i < size_; ++i) {
+            f(data[i]);
+        }
+    }
+
+private:
+    // Переносит до count элементов из старого блока и освобождает его, когда перенос закончен
+    void Migrate(size_t count) noexcept {
+        if (old_.Capacity() == 0) {
+            return;
+        }
+        // Шаг обычно в несколько элементов, и простой цикл дешевле вызова memmove
+        const size_t end = std::min(old_size_, migrated_ + count);
+        for (; migrated_ < end; ++migrated_) {
+            std::construct_at(data_ + migrated_, std::move(old_[migrated_]));
+            std::destroy_at(old_ + migrated_);
+        }
+        if (migrated_ == old_size_) {
+            RawMemory<T>::Tracking::OnGrowth(old_size_);
+            old_ = RawMemory<T>();
+            old_size_ = 0;
+            migrated_ = 0;
+        }
+    }
+
+    // Элементы [migrated_, old_size_) лежат в old_, остальные — в data_ под своими индексами
+    RawMemory<T> data_;
+    RawMemory<T> old_;
+    size_t size_ = 0;
+    size_t old_size_ = 0;
+    size_t migrated_ = 0;
+    size_t migration_step_;
+};
\ No newline at end of file
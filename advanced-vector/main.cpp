@@ -1,662 +1,1765 @@
-#include "vector.h"
-
-#include <iostream>
-#include <stdexcept>
-#include <string>
-#include <vector>
-
-namespace {
-
-    // "" ,     
-    inline const uint32_t DEFAULT_COOKIE = 0xdeadbeef;
-
-    struct TestObj {
-        TestObj() = default;
-        TestObj(const TestObj& other) = default;
-        TestObj& operator=(const TestObj& other) = default;
-        TestObj(TestObj&& other) = default;
-        TestObj& operator=(TestObj&& other) = default;
-        ~TestObj() {
-            cookie = 0;
-        }
-        [[nodiscard]] bool IsAlive() const noexcept {
-            return cookie == DEFAULT_COOKIE;
-        }
-        uint32_t cookie = DEFAULT_COOKIE;
-    };
-
-    struct Obj {
-        Obj() {
-            if (default_construction_throw_countdown > 0) {
-                if (--default_construction_throw_countdown == 0) {
-                    throw std::runtime_error("Oops");
-                }
-            }
-            ++num_default_constructed;
-        }
-
-        explicit Obj(int id)
-            : id(id)  //
-        {
-            ++num_constructed_with_id;
-        }
-
-        Obj(int id, std::string name)
-            : id(id)
-            , name(std::move(name))  //
-        {
-            ++num_constructed_with_id_and_name;
-        }
-
-        Obj(const Obj& other)
-            : id(other.id)  //
-        {
-            if (other.throw_on_copy) {
-                throw std::runtime_error("Oops");
-            }
-            ++num_copied;
-        }
-
-        Obj(Obj&& other) noexcept
-            : id(other.id)  //
-        {
-            ++num_moved;
-        }
-
-        Obj& operator=(const Obj& other) {
-            if (this != &other) {
-                id = other.id;
-                name = other.name;
-                ++num_assigned;
-            }
-            return *this;
-        }
-
-        Obj& operator=(Obj&& other) noexcept {
-            id = other.id;
-            name = std::move(other.name);
-            ++num_move_assigned;
-            return *this;
-        }
-
-        ~Obj() {
-            ++num_destroyed;
-            id = 0;
-        }
-
-        static int GetAliveObjectCount() {
-            return num_default_constructed + num_copied + num_moved + num_constructed_with_id
-                + num_constructed_with_id_and_name - num_destroyed;
-        }
-
-        static void ResetCounters() {
-            default_construction_throw_countdown = 0;
-            num_default_constructed = 0;
-            num_copied = 0;
-            num_moved = 0;
-            num_destroyed = 0;
-            num_constructed_with_id = 0;
-            num_constructed_with_id_and_name = 0;
-            num_assigned = 0;
-            num_move_assigned = 0;
-        }
-
-        bool throw_on_copy = false;
-        int id = 0;
-        std::string name;
-
-        static inline int default_construction_throw_countdown = 0;
-        static inline int num_default_constructed = 0;
-        static inline int num_constructed_with_id = 0;
-        static inline int num_constructed_with_id_and_name = 0;
-        static inline int num_copied = 0;
-        static inline int num_moved = 0;
-        static inline int num_destroyed = 0;
-        static inline int num_assigned = 0;
-        static inline int num_move_assigned = 0;
-    };
-
-}  // namespace
-
-void Test1() {
-    Obj::ResetCounters();
-    const size_t SIZE = 100500;
-    const size_t INDEX = 10;
-    const int MAGIC = 42;
-    {
-        Vector<int> v;
-        assert(v.Capacity() == 0);
-        assert(v.Size() == 0);
-
-        v.Reserve(SIZE);
-        assert(v.Capacity() == SIZE);
-        assert(v.Size() == 0);
-    }
-    {
-        Vector<int> v(SIZE);
-        const auto& cv(v);
-        assert(v.Capacity() == SIZE);
-        assert(v.Size() == SIZE);
-        assert(v[0] == 0);
-        assert(&v[0] == &cv[0]);
-        v[INDEX] = MAGIC;
-        assert(v[INDEX] == MAGIC);
-        assert(&v[100] - &v[0] == 100);
-
-        v.Reserve(SIZE * 2);
-        assert(v.Size() == SIZE);
-        assert(v.Capacity() == SIZE * 2);
-        assert(v[INDEX] == MAGIC);
-    }
-    {
-        Vector<int> v(SIZE);
-        v[INDEX] = MAGIC;
-        const auto v_copy(v);
-        assert(&v[INDEX] != &v_copy[INDEX]);
-        assert(v[INDEX] == v_copy[INDEX]);
-    }
-    {
-        Vector<Obj> v;
-        v.Reserve(SIZE);
-        assert(Obj::GetAliveObjectCount() == 0);
-    }
-    {
-        Vector<Obj> v(SIZE);
-        assert(Obj::GetAliveObjectCount() == SIZE);
-        const int old_copy_count = Obj::num_copied;
-        const int old_move_count = Obj::num_moved;
-        v.Reserve(SIZE * 2);
-        assert(Obj::GetAliveObjectCount() == SIZE);
-        assert(Obj::num_copied == old_copy_count);
-        assert(Obj::num_moved == old_move_count + static_cast<int>(SIZE));
-    }
-    assert(Obj::GetAliveObjectCount() == 0);
-}
-
-void Test2() {
-    const size_t SIZE = 100;
-    Obj::ResetCounters();
-    {
-        Obj::default_construction_throw_countdown = SIZE / 2;
-        try {
-            Vector<Obj> v(SIZE);
-            assert(false && "Exception is expected");
-        }
-        catch (const std::runtime_error&) {
-        }
-        catch (...) {
-            // Unexpected error
-            assert(false && "Unexpected exception");
-        }
-        assert(Obj::num_default_constructed == SIZE / 2 - 1);
-        assert(Obj::GetAliveObjectCount() == 0);
-    }
-    Obj::ResetCounters();
-    {
-        Vector<Obj> v(SIZE);
-        try {
-            v[SIZE / 2].throw_on_copy = true;
-            Vector<Obj> v_copy(v);
-            assert(false && "Exception is expected");
-        }
-        catch (const std::runtime_error&) {
-            assert(Obj::num_copied == SIZE / 2);
-        }
-        catch (...) {
-            // Unexpected error
-            assert(false && "Unexpected exception");
-        }
-        assert(Obj::GetAliveObjectCount() == SIZE);
-    }
-    Obj::ResetCounters();
-    {
-        Vector<Obj> v(SIZE);
-        try {
-            v[SIZE - 1].throw_on_copy = true;
-            v.Reserve(SIZE * 2);
-        }
-        catch (...) {
-            // Unexpected error
-            assert(false && "Unexpected exception");
-        }
-        assert(v.Capacity() == SIZE * 2);
-        assert(v.Size() == SIZE);
-        assert(Obj::GetAliveObjectCount() == SIZE);
-    }
-}
-
-void Test3() {
-    const size_t MEDIUM_SIZE = 100;
-    const size_t LARGE_SIZE = 250;
-    const int ID = 42;
-    {
-        Obj::ResetCounters();
-        Vector<int> v(MEDIUM_SIZE);
-        {
-            auto v_copy(std::move(v));
-
-            assert(v_copy.Size() == MEDIUM_SIZE);
-            assert(v_copy.Capacity() == MEDIUM_SIZE);
-        }
-        assert(Obj::GetAliveObjectCount() == 0);
-    }
-    {
-        Obj::ResetCounters();
-        {
-            Vector<Obj> v(MEDIUM_SIZE);
-            v[MEDIUM_SIZE / 2].id = ID;
-            assert(Obj::num_default_constructed == MEDIUM_SIZE);
-            Vector<Obj> moved_from_v(std::move(v));
-            assert(moved_from_v.Size() == MEDIUM_SIZE);
-            assert(moved_from_v[MEDIUM_SIZE / 2].id == ID);
-        }
-        assert(Obj::GetAliveObjectCount() == 0);
-
-        assert(Obj::num_moved == 0);
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_default_constructed == MEDIUM_SIZE);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v_medium(MEDIUM_SIZE);
-        v_medium[MEDIUM_SIZE / 2].id = ID;
-        Vector<Obj> v_large(LARGE_SIZE);
-        v_large = v_medium;
-        assert(v_large.Size() == MEDIUM_SIZE);
-        assert(v_large.Capacity() == LARGE_SIZE);
-        assert(v_large[MEDIUM_SIZE / 2].id == ID);
-        assert(Obj::GetAliveObjectCount() == MEDIUM_SIZE + MEDIUM_SIZE);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v(MEDIUM_SIZE);
-        {
-            Vector<Obj> v_large(LARGE_SIZE);
-            v_large[LARGE_SIZE - 1].id = ID;
-            v = v_large;
-            assert(v.Size() == LARGE_SIZE);
-            assert(v_large.Capacity() == LARGE_SIZE);
-            assert(v_large[LARGE_SIZE - 1].id == ID);
-            assert(Obj::GetAliveObjectCount() == LARGE_SIZE + LARGE_SIZE);
-        }
-        assert(Obj::GetAliveObjectCount() == LARGE_SIZE);
-    }
-    assert(Obj::GetAliveObjectCount() == 0);
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v(MEDIUM_SIZE);
-        v[MEDIUM_SIZE - 1].id = ID;
-        Vector<Obj> v_small(MEDIUM_SIZE / 2);
-        v_small.Reserve(MEDIUM_SIZE + 1);
-        const size_t num_copies = Obj::num_copied;
-        v_small = v;
-        assert(v_small.Size() == v.Size());
-        assert(v_small.Capacity() == MEDIUM_SIZE + 1);
-        v_small[MEDIUM_SIZE - 1].id = ID;
-        assert(Obj::num_copied - num_copies == MEDIUM_SIZE - (MEDIUM_SIZE / 2));
-    }
-}
-
-void Test4() {
-    const size_t ID = 42;
-    const size_t SIZE = 100'500;
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v;
-        v.Resize(SIZE);
-        assert(v.Size() == SIZE);
-        assert(v.Capacity() == SIZE);
-        assert(Obj::num_default_constructed == SIZE);
-    }
-    assert(Obj::GetAliveObjectCount() == 0);
-
-    {
-        const size_t NEW_SIZE = 10'000;
-        Obj::ResetCounters();
-        Vector<Obj> v(SIZE);
-        v.Resize(NEW_SIZE);
-        assert(v.Size() == NEW_SIZE);
-        assert(v.Capacity() == SIZE);
-        assert(Obj::num_destroyed == SIZE - NEW_SIZE);
-    }
-    assert(Obj::GetAliveObjectCount() == 0);
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v(SIZE);
-        Obj o{ ID };
-        v.PushBack(o);
-        assert(v.Size() == SIZE + 1);
-        assert(v.Capacity() == SIZE * 2);
-        assert(v[SIZE].id == ID);
-        assert(Obj::num_default_constructed == SIZE);
-        assert(Obj::num_copied == 1);
-        assert(Obj::num_constructed_with_id == 1);
-        assert(Obj::num_moved == SIZE);
-    }
-    assert(Obj::GetAliveObjectCount() == 0);
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v(SIZE);
-        v.PushBack(Obj{ ID });
-        assert(v.Size() == SIZE + 1);
-        assert(v.Capacity() == SIZE * 2);
-        assert(v[SIZE].id == ID);
-        assert(Obj::num_default_constructed == SIZE);
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_constructed_with_id == 1);
-        assert(Obj::num_moved == SIZE + 1);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v;
-        v.PushBack(Obj{ ID });
-        v.PopBack();
-        assert(v.Size() == 0);
-        assert(v.Capacity() == 1);
-        assert(Obj::GetAliveObjectCount() == 0);
-    }
-
-    {
-        Vector<TestObj> v(1);
-        assert(v.Size() == v.Capacity());
-        //  PushBack      
-        //    
-        v.PushBack(v[0]);
-        assert(v[0].IsAlive());
-        assert(v[1].IsAlive());
-    }
-    {
-        Vector<TestObj> v(1);
-        assert(v.Size() == v.Capacity());
-        //  PushBack        
-        //    
-        v.PushBack(std::move(v[0]));
-        assert(v[0].IsAlive());
-        assert(v[1].IsAlive());
-    }
-}
-
-void Test5() {
-    const int ID = 42;
-    using namespace std::literals;
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v;
-        auto& elem = v.EmplaceBack(ID, "Ivan"s);
-        assert(v.Capacity() == 1);
-        assert(v.Size() == 1);
-        assert(&elem == &v[0]);
-        assert(v[0].id == ID);
-        assert(v[0].name == "Ivan"s);
-        assert(Obj::num_constructed_with_id_and_name == 1);
-        assert(Obj::GetAliveObjectCount() == 1);
-    }
-    assert(Obj::GetAliveObjectCount() == 0);
-    {
-        Vector<TestObj> v(1);
-        assert(v.Size() == v.Capacity());
-        //  EmplaceBack      
-        //    
-        v.EmplaceBack(v[0]);
-        assert(v[0].IsAlive());
-        assert(v[1].IsAlive());
-    }
-}
-
-void Test6() {
-    using namespace std::literals;
-    const size_t SIZE = 10;
-    const int ID = 42;
-    {
-        Obj::ResetCounters();
-        Vector<int> v(SIZE);
-        const auto& cv(v);
-        v.PushBack(1);
-        assert(&*v.begin() == &v[0]);
-        *v.begin() = 2;
-        assert(v[0] == 2);
-        assert(v.end() - v.begin() == static_cast<std::ptrdiff_t>(v.Size()));
-        assert(v.begin() == cv.begin());
-        assert(v.end() == cv.end());
-        assert(v.cbegin() == cv.begin());
-        assert(v.cend() == cv.end());
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v{ SIZE };
-        Obj obj{ 1 };
-        Vector<Obj>::iterator pos = v.Insert(v.cbegin() + 1, obj);
-        assert(v.Size() == SIZE + 1);
-        assert(v.Capacity() == SIZE * 2);
-        assert(&*pos == &v[1]);
-        assert(v[1].id == obj.id);
-        assert(Obj::num_copied == 1);
-        assert(Obj::num_default_constructed == SIZE);
-        assert(Obj::GetAliveObjectCount() == SIZE + 2);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v;
-        auto* pos = v.Emplace(v.end(), Obj{ 1 });
-        assert(v.Size() == 1);
-        assert(v.Capacity() >= v.Size());
-        assert(&*pos == &v[0]);
-        assert(Obj::num_moved == 1);
-        assert(Obj::num_constructed_with_id == 1);
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_assigned == 0);
-        assert(Obj::num_move_assigned == 0);
-        assert(Obj::GetAliveObjectCount() == 1);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v;
-        v.Reserve(SIZE);
-        auto* pos = v.Emplace(v.end(), Obj{ 1 });
-        assert(v.Size() == 1);
-        assert(v.Capacity() >= v.Size());
-        assert(&*pos == &v[0]);
-        assert(Obj::num_moved == 1);
-        assert(Obj::num_constructed_with_id == 1);
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_assigned == 0);
-        assert(Obj::num_move_assigned == 0);
-        assert(Obj::GetAliveObjectCount() == 1);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v{ SIZE };
-        Vector<Obj>::iterator pos = v.Insert(v.cbegin() + 1, Obj{ 1 });
-        assert(v.Size() == SIZE + 1);
-        assert(v.Capacity() == SIZE * 2);
-        assert(&*pos == &v[1]);
-        assert(v[1].id == 1);
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_default_constructed == SIZE);
-        assert(Obj::GetAliveObjectCount() == SIZE + 1);
-    }
-    {
-        Vector<TestObj> v{ SIZE };
-        v.Insert(v.cbegin() + 2, v[0]);
-        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
-            return obj.IsAlive();
-            }));
-    }
-    {
-        Vector<TestObj> v{ SIZE };
-        v.Insert(v.cbegin() + 2, std::move(v[0]));
-        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
-            return obj.IsAlive();
-            }));
-    }
-    {
-        Vector<TestObj> v{ SIZE };
-        v.Emplace(v.cbegin() + 2, std::move(v[0]));
-        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
-            return obj.IsAlive();
-            }));
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v{ SIZE };
-        auto* pos = v.Emplace(v.cbegin() + 1, ID, "Ivan"s);
-        assert(v.Size() == SIZE + 1);
-        assert(v.Capacity() == SIZE * 2);
-        assert(&*pos == &v[1]);
-        assert(v[1].id == ID);
-        assert(v[1].name == "Ivan"s);
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_default_constructed == SIZE);
-        assert(Obj::num_moved == SIZE);
-        assert(Obj::num_move_assigned == 0);
-        assert(Obj::num_assigned == 0);
-        assert(Obj::GetAliveObjectCount() == SIZE + 1);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v{ SIZE };
-        auto* pos = v.Emplace(v.cbegin() + v.Size(), ID, "Ivan"s);
-        assert(v.Size() == SIZE + 1);
-        assert(v.Capacity() == SIZE * 2);
-        assert(&*pos == &v[SIZE]);
-        assert(v[SIZE].id == ID);
-        assert(v[SIZE].name == "Ivan"s);
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_default_constructed == SIZE);
-        assert(Obj::num_moved == SIZE);
-        assert(Obj::num_move_assigned == 0);
-        assert(Obj::num_assigned == 0);
-        assert(Obj::GetAliveObjectCount() == SIZE + 1);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v{ SIZE };
-        v.Reserve(SIZE * 2);
-        const int old_num_moved = Obj::num_moved;
-        assert(v.Capacity() == SIZE * 2);
-        auto* pos = v.Emplace(v.cbegin() + 3, ID, "Ivan"s);
-        assert(v.Size() == SIZE + 1);
-        assert(&*pos == &v[3]);
-        assert(v[3].id == ID);
-        assert(v[3].name == "Ivan");
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_default_constructed == SIZE);
-        assert(Obj::num_constructed_with_id_and_name == 1);
-        assert(Obj::num_moved == old_num_moved + 1);
-        assert(Obj::num_move_assigned == SIZE - 3);
-        assert(Obj::num_assigned == 0);
-    }
-    {
-        Obj::ResetCounters();
-        Vector<Obj> v{ SIZE };
-        v[2].id = ID;
-        auto* pos = v.Erase(v.cbegin() + 1);
-        assert((pos - v.begin()) == 1);
-        assert(v.Size() == SIZE - 1);
-        assert(v.Capacity() == SIZE);
-        assert(pos->id == ID);
-        assert(Obj::num_copied == 0);
-        assert(Obj::num_assigned == 0);
-        assert(Obj::num_move_assigned == SIZE - 2);
-        assert(Obj::num_moved == 0);
-        assert(Obj::GetAliveObjectCount() == SIZE - 1);
-    }
-}
-
-struct C {
-    C() noexcept {
-        ++def_ctor;
-    }
-    C(const C& /*other*/) noexcept {
-        ++copy_ctor;
-    }
-    C(C&& /*other*/) noexcept {
-        ++move_ctor;
-    }
-    C& operator=(const C& other) noexcept {
-        if (this != &other) {
-            ++copy_assign;
-        }
-        return *this;
-    }
-    C& operator=(C&& /*other*/) noexcept {
-        ++move_assign;
-        return *this;
-    }
-    ~C() {
-        ++dtor;
-    }
-
-    static void Reset() {
-        def_ctor = 0;
-        copy_ctor = 0;
-        move_ctor = 0;
-        copy_assign = 0;
-        move_assign = 0;
-        dtor = 0;
-    }
-
-    inline static size_t def_ctor = 0;
-    inline static size_t copy_ctor = 0;
-    inline static size_t move_ctor = 0;
-    inline static size_t copy_assign = 0;
-    inline static size_t move_assign = 0;
-    inline static size_t dtor = 0;
-};
-
-void Dump() {
-    using namespace std;
-    cerr << "Def ctors: "sv << C::def_ctor              //
-        << ", Copy ctors: "sv << C::copy_ctor          //
-        << ", Move ctors: "sv << C::move_ctor          //
-        << ", Copy assignments: "sv << C::copy_assign  //
-        << ", Move assignments: "sv << C::move_assign  //
-        << ", Dtors: "sv << C::dtor << endl;
-}
-
-void Benchmark() {
-    using namespace std;
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "std::vector:"sv << endl;
-            C::Reset();
-            vector<C> v(NUM);
-            Dump();
-            v.push_back(c);
-        }
-        Dump();
-    }
-    catch (...) {
-    }
-    try {
-        const size_t NUM = 10;
-        C c;
-        {
-            cerr << "Vector:"sv << endl;
-            C::Reset();
-            Vector<C> v(NUM);
-            Dump();
-            v.PushBack(c);
-        }
-        Dump();
-    }
-    catch (...) {
-    }
-}
-
-int main() {
-    try {
-        Test1();
-        Test2();
-        Test3();
-        Test4();
-        Test5();
-        Test6();
-        Benchmark();
-    }
-    catch (const std::exception& e) {
-        std::cerr << e.what() << std::endl;
-    }
+#include "async_stream.h"
+#include "counting_type.h"
+#include "deferred_destroy.h"
+#include "gather.h"
+#include "incremental_vector.h"
+#include "matrix.h"
+#include "numeric.h"
+#include "parallel_copy.h"
+#include "pipeline.h"
+#include "pregrowing_vector.h"
+#include "rcu_vector.h"
+#include "scan.h"
+#include "set_ops.h"
+#include "shared_memory_vector.h"
+#include "static_vector.h"
+#include "test_types.h"
+#include "views.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    // "Магическое" число, используемое для отслеживания живости объекта
+    inline const uint32_t DEFAULT_COOKIE = 0xdeadbeef;
+
+    struct TestObj {
+        TestObj() = default;
+        TestObj(const TestObj& other) = default;
+        TestObj& operator=(const TestObj& other) = default;
+        TestObj(TestObj&& other) = default;
+        TestObj& operator=(TestObj&& other) = default;
+        ~TestObj() {
+            cookie = 0;
+        }
+        [[nodiscard]] bool IsAlive() const noexcept {
+            return cookie == DEFAULT_COOKIE;
+        }
+        uint32_t cookie = DEFAULT_COOKIE;
+    };
+
+}  // namespace
+
+// Учёт выделений памяти включён только для Obj, см. Test7
+template <>
+struct AllocationPolicy<Obj> {
+    using type = TrackAllocations<Obj>;
+};
+
+void Test1() {
+    Obj::ResetCounters();
+    const size_t SIZE = 100500;
+    const size_t INDEX = 10;
+    const int MAGIC = 42;
+    {
+        Vector<int> v;
+        assert(v.Capacity() == 0);
+        assert(v.Size() == 0);
+
+        v.Reserve(SIZE);
+        assert(v.Capacity() == SIZE);
+        assert(v.Size() == 0);
+    }
+    {
+        Vector<int> v(SIZE);
+        const auto& cv(v);
+        assert(v.Capacity() == SIZE);
+        assert(v.Size() == SIZE);
+        assert(v[0] == 0);
+        assert(&v[0] == &cv[0]);
+        v[INDEX] = MAGIC;
+        assert(v[INDEX] == MAGIC);
+        assert(&v[100] - &v[0] == 100);
+
+        v.Reserve(SIZE * 2);
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[INDEX] == MAGIC);
+    }
+    {
+        Vector<int> v(SIZE);
+        v[INDEX] = MAGIC;
+        const auto v_copy(v);
+        assert(&v[INDEX] != &v_copy[INDEX]);
+        assert(v[INDEX] == v_copy[INDEX]);
+    }
+    {
+        Vector<Obj> v;
+        v.Reserve(SIZE);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Vector<Obj> v(SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+        const int old_copy_count = Obj::num_copied;
+        const int old_move_count = Obj::num_moved;
+        v.Reserve(SIZE * 2);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+        assert(Obj::num_copied == old_copy_count);
+        assert(Obj::num_moved == old_move_count + static_cast<int>(SIZE));
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+}
+
+void Test2() {
+    const size_t SIZE = 100;
+    Obj::ResetCounters();
+    {
+        Obj::default_construction_throw_countdown = SIZE / 2;
+        try {
+            Vector<Obj> v(SIZE);
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&) {
+        }
+        catch (...) {
+            // Unexpected error
+            assert(false && "Unexpected exception");
+        }
+        assert(Obj::num_default_constructed == SIZE / 2 - 1);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    Obj::ResetCounters();
+    {
+        Vector<Obj> v(SIZE);
+        try {
+            v[SIZE / 2].throw_on_copy = true;
+            Vector<Obj> v_copy(v);
+            assert(false && "Exception is expected");
+        }
+        catch (const std::runtime_error&) {
+            assert(Obj::num_copied == SIZE / 2);
+        }
+        catch (...) {
+            // Unexpected error
+            assert(false && "Unexpected exception");
+        }
+        assert(Obj::GetAliveObjectCount() == SIZE);
+    }
+    Obj::ResetCounters();
+    {
+        Vector<Obj> v(SIZE);
+        try {
+            v[SIZE - 1].throw_on_copy = true;
+            v.Reserve(SIZE * 2);
+        }
+        catch (...) {
+            // Unexpected error
+            assert(false && "Unexpected exception");
+        }
+        assert(v.Capacity() == SIZE * 2);
+        assert(v.Size() == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE);
+    }
+}
+
+void Test3() {
+    const size_t MEDIUM_SIZE = 100;
+    const size_t LARGE_SIZE = 250;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        Vector<int> v(MEDIUM_SIZE);
+        {
+            auto v_copy(std::move(v));
+
+            assert(v_copy.Size() == MEDIUM_SIZE);
+            assert(v_copy.Capacity() == MEDIUM_SIZE);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+    {
+        Obj::ResetCounters();
+        {
+            Vector<Obj> v(MEDIUM_SIZE);
+            v[MEDIUM_SIZE / 2].id = ID;
+            assert(Obj::num_default_constructed == MEDIUM_SIZE);
+            Vector<Obj> moved_from_v(std::move(v));
+            assert(moved_from_v.Size() == MEDIUM_SIZE);
+            assert(moved_from_v[MEDIUM_SIZE / 2].id == ID);
+        }
+        assert(Obj::GetAliveObjectCount() == 0);
+
+        assert(Obj::num_moved == 0);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_default_constructed == MEDIUM_SIZE);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v_medium(MEDIUM_SIZE);
+        v_medium[MEDIUM_SIZE / 2].id = ID;
+        Vector<Obj> v_large(LARGE_SIZE);
+        v_large = v_medium;
+        assert(v_large.Size() == MEDIUM_SIZE);
+        assert(v_large.Capacity() == LARGE_SIZE);
+        assert(v_large[MEDIUM_SIZE / 2].id == ID);
+        assert(Obj::GetAliveObjectCount() == MEDIUM_SIZE + MEDIUM_SIZE);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(MEDIUM_SIZE);
+        {
+            Vector<Obj> v_large(LARGE_SIZE);
+            v_large[LARGE_SIZE - 1].id = ID;
+            v = v_large;
+            assert(v.Size() == LARGE_SIZE);
+            assert(v_large.Capacity() == LARGE_SIZE);
+            assert(v_large[LARGE_SIZE - 1].id == ID);
+            assert(Obj::GetAliveObjectCount() == LARGE_SIZE + LARGE_SIZE);
+        }
+        assert(Obj::GetAliveObjectCount() == LARGE_SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(MEDIUM_SIZE);
+        v[MEDIUM_SIZE - 1].id = ID;
+        Vector<Obj> v_small(MEDIUM_SIZE / 2);
+        v_small.Reserve(MEDIUM_SIZE + 1);
+        const size_t num_copies = Obj::num_copied;
+        v_small = v;
+        assert(v_small.Size() == v.Size());
+        assert(v_small.Capacity() == MEDIUM_SIZE + 1);
+        v_small[MEDIUM_SIZE - 1].id = ID;
+        assert(Obj::num_copied - num_copies == MEDIUM_SIZE - (MEDIUM_SIZE / 2));
+    }
+}
+
+void Test4() {
+    const size_t ID = 42;
+    const size_t SIZE = 100'500;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Resize(SIZE);
+        assert(v.Size() == SIZE);
+        assert(v.Capacity() == SIZE);
+        assert(Obj::num_default_constructed == SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+
+    {
+        const size_t NEW_SIZE = 10'000;
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.Resize(NEW_SIZE);
+        assert(v.Size() == NEW_SIZE);
+        assert(v.Capacity() == SIZE);
+        assert(Obj::num_destroyed == SIZE - NEW_SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        Obj o{ ID };
+        v.PushBack(o);
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[SIZE].id == ID);
+        assert(Obj::num_default_constructed == SIZE);
+        assert(Obj::num_copied == 1);
+        assert(Obj::num_constructed_with_id == 1);
+        assert(Obj::num_moved == SIZE);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v(SIZE);
+        v.PushBack(Obj{ ID });
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 2);
+        assert(v[SIZE].id == ID);
+        assert(Obj::num_default_constructed == SIZE);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_constructed_with_id == 1);
+        assert(Obj::num_moved == SIZE + 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.PushBack(Obj{ ID });
+        v.PopBack();
+        assert(v.Size() == 0);
+        assert(v.Capacity() == 1);
+        assert(Obj::GetAliveObjectCount() == 0);
+    }
+
+    {
+        Vector<TestObj> v(1);
+        assert(v.Size() == v.Capacity());
+        // Операция PushBack существующего элемента вектора должна быть безопасна
+        // даже при реаллокации памяти
+        v.PushBack(v[0]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+    }
+    {
+        Vector<TestObj> v(1);
+        assert(v.Size() == v.Capacity());
+        // Операция PushBack для перемещения существующего элемента вектора должна быть безопасна
+        // даже при реаллокации памяти
+        v.PushBack(std::move(v[0]));
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+    }
+}
+
+void Test5() {
+    const int ID = 42;
+    using namespace std::literals;
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        auto& elem = v.EmplaceBack(ID, "Ivan"s);
+        assert(v.Capacity() == 1);
+        assert(v.Size() == 1);
+        assert(&elem == &v[0]);
+        assert(v[0].id == ID);
+        assert(v[0].name == "Ivan"s);
+        assert(Obj::num_constructed_with_id_and_name == 1);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    assert(Obj::GetAliveObjectCount() == 0);
+    {
+        Vector<TestObj> v(1);
+        assert(v.Size() == v.Capacity());
+        // Операция EmplaceBack существующего элемента вектора должна быть безопасна
+        // даже при реаллокации памяти
+        v.EmplaceBack(v[0]);
+        assert(v[0].IsAlive());
+        assert(v[1].IsAlive());
+    }
+}
+
+void Test6() {
+    using namespace std::literals;
+    const size_t SIZE = 10;
+    const int ID = 42;
+    {
+        Obj::ResetCounters();
+        Vector<int> v(SIZE);
+        const auto& cv(v);
+        v.PushBack(1);
+        assert(&*v.begin() == &v[0]);
+        *v.begin() = 2;
+        assert(v[0] == 2);
+        assert(v.end() - v.begin() == static_cast<std::ptrdiff_t>(v.Size()));
+        assert(v.begin() == cv.begin());
+        assert(v.end() == cv.end());
+        assert(v.cbegin() == cv.begin());
+        assert(v.cend() == cv.end());
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v{ SIZE };
+        Obj obj{ 1 };
+        Vector<Obj>::iterator pos = v.Insert(v.cbegin() + 1, obj);
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 2);
+        assert(&*pos == &v[1]);
+        assert(v[1].id == obj.id);
+        assert(Obj::num_copied == 1);
+        assert(Obj::num_default_constructed == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE + 2);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        auto* pos = v.Emplace(v.end(), Obj{ 1 });
+        assert(v.Size() == 1);
+        assert(v.Capacity() >= v.Size());
+        assert(&*pos == &v[0]);
+        assert(Obj::num_moved == 1);
+        assert(Obj::num_constructed_with_id == 1);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_assigned == 0);
+        assert(Obj::num_move_assigned == 0);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v;
+        v.Reserve(SIZE);
+        auto* pos = v.Emplace(v.end(), Obj{ 1 });
+        assert(v.Size() == 1);
+        assert(v.Capacity() >= v.Size());
+        assert(&*pos == &v[0]);
+        assert(Obj::num_moved == 1);
+        assert(Obj::num_constructed_with_id == 1);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_assigned == 0);
+        assert(Obj::num_move_assigned == 0);
+        assert(Obj::GetAliveObjectCount() == 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v{ SIZE };
+        Vector<Obj>::iterator pos = v.Insert(v.cbegin() + 1, Obj{ 1 });
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 2);
+        assert(&*pos == &v[1]);
+        assert(v[1].id == 1);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_default_constructed == SIZE);
+        assert(Obj::GetAliveObjectCount() == SIZE + 1);
+    }
+    {
+        Vector<TestObj> v{ SIZE };
+        v.Insert(v.cbegin() + 2, v[0]);
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+            }));
+    }
+    {
+        Vector<TestObj> v{ SIZE };
+        v.Insert(v.cbegin() + 2, std::move(v[0]));
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+            }));
+    }
+    {
+        Vector<TestObj> v{ SIZE };
+        v.Emplace(v.cbegin() + 2, std::move(v[0]));
+        assert(std::all_of(v.begin(), v.end(), [](const TestObj& obj) {
+            return obj.IsAlive();
+            }));
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v{ SIZE };
+        auto* pos = v.Emplace(v.cbegin() + 1, ID, "Ivan"s);
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 2);
+        assert(&*pos == &v[1]);
+        assert(v[1].id == ID);
+        assert(v[1].name == "Ivan"s);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_default_constructed == SIZE);
+        assert(Obj::num_moved == SIZE);
+        assert(Obj::num_move_assigned == 0);
+        assert(Obj::num_assigned == 0);
+        assert(Obj::GetAliveObjectCount() == SIZE + 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v{ SIZE };
+        auto* pos = v.Emplace(v.cbegin() + v.Size(), ID, "Ivan"s);
+        assert(v.Size() == SIZE + 1);
+        assert(v.Capacity() == SIZE * 2);
+        assert(&*pos == &v[SIZE]);
+        assert(v[SIZE].id == ID);
+        assert(v[SIZE].name == "Ivan"s);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_default_constructed == SIZE);
+        assert(Obj::num_moved == SIZE);
+        assert(Obj::num_move_assigned == 0);
+        assert(Obj::num_assigned == 0);
+        assert(Obj::GetAliveObjectCount() == SIZE + 1);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v{ SIZE };
+        v.Reserve(SIZE * 2);
+        const int old_num_moved = Obj::num_moved;
+        assert(v.Capacity() == SIZE * 2);
+        auto* pos = v.Emplace(v.cbegin() + 3, ID, "Ivan"s);
+        assert(v.Size() == SIZE + 1);
+        assert(&*pos == &v[3]);
+        assert(v[3].id == ID);
+        assert(v[3].name == "Ivan");
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_default_constructed == SIZE);
+        assert(Obj::num_constructed_with_id_and_name == 1);
+        assert(Obj::num_moved == old_num_moved + 1);
+        assert(Obj::num_move_assigned == SIZE - 3);
+        assert(Obj::num_assigned == 0);
+    }
+    {
+        Obj::ResetCounters();
+        Vector<Obj> v{ SIZE };
+        v[2].id = ID;
+        auto* pos = v.Erase(v.cbegin() + 1);
+        assert((pos - v.begin()) == 1);
+        assert(v.Size() == SIZE - 1);
+        assert(v.Capacity() == SIZE);
+        assert(pos->id == ID);
+        assert(Obj::num_copied == 0);
+        assert(Obj::num_assigned == 0);
+        assert(Obj::num_move_assigned == SIZE - 2);
+        assert(Obj::num_moved == 0);
+        assert(Obj::GetAliveObjectCount() == SIZE - 1);
+    }
+}
+
+void Test7() {
+    const int COUNT = 5;
+    ResetAllocationStats<Obj>();
+    {
+        Vector<Obj> v;
+        for (int i = 0; i < COUNT; ++i) {
+            v.PushBack(Obj{ i });
+        }
+        // Ёмкость росла как 1, 2, 4, 8
+        const auto stats = GetAllocationStats<Obj>();
+        assert(stats.allocations == 4);
+        assert(stats.deallocations == 3);
+        assert(stats.LiveBytes() == 8 * sizeof(Obj));
+        assert(stats.peak_bytes == (4 + 8) * sizeof(Obj));
+        assert(stats.growths == 4);
+        assert(stats.relocated_elements == 1 + 2 + 4);
+
+        Vector<Obj> moved(std::move(v));
+        Vector<Obj> other(1);
+        other = std::move(moved);
+        assert(GetAllocationStats<Obj>().allocations == 5);
+    }
+    const auto stats = GetAllocationStats<Obj>();
+    assert(stats.deallocations == stats.allocations);
+    assert(stats.LiveBytes() == 0);
+#ifndef ADVANCED_VECTOR_TRACK_ALLOCATIONS
+    assert(GetAllocationStats<int>().allocations == 0);
+#endif
+}
+
+#ifdef ADVANCED_VECTOR_TRACK_CAPACITY
+void Test8() {
+    const auto& registry = CapacityRegistry::Instance();
+    const auto find_double = [](const CapacityReport& report) {
+        return std::find_if(report.types.begin(), report.types.end(), [](const auto& usage) {
+            return usage.type_name == "double";
+        });
+    };
+    // Рост считается за всё время работы, а векторы double создают и предыдущие тесты
+    const auto before = registry.Snapshot();
+    const size_t old_growths = find_double(before) == before.types.end() ? 0 : find_double(before)->growths;
+    {
+        Vector<double> v;
+        v.Reserve(100);
+        v.PushBack(1.0);
+        Vector<double> copy(v);
+        Vector<double> empty;
+        const auto report = registry.Snapshot();
+        // v заполнен на 1%, копия — полностью, пустой вектор в гистограмму не попадает
+        assert(report.utilization[0] >= 1);
+        assert(report.utilization[CapacityReport::UTILIZATION_BUCKETS - 1] >= 1);
+        const auto it = find_double(report);
+        assert(it != report.types.end());
+        assert(it->vectors == 3);
+        assert(it->WastedBytes() == 99 * sizeof(double));
+        assert(it->growths == old_growths + 1);
+    }
+    const auto report = registry.Snapshot();
+    const auto it = find_double(report);
+    assert(it != report.types.end() && it->vectors == 0);
+}
+#endif
+
+#ifdef ADVANCED_VECTOR_TRACE
+void Test9() {
+    const std::string path = (std::filesystem::temp_directory_path() / "advanced_vector_trace.bin").string();
+    auto& tracer = VectorTracer::Instance();
+    tracer.Start(path, 4);
+    {
+        Vector<int> v;
+        v.Reserve(10);
+        v.PushBack(1);
+        v.EmplaceBack(2);
+        v.Erase(v.begin());
+    }
+    assert(tracer.Stop());
+    // В кольце на 4 записи остаются последние операции
+    const auto records = ReadTrace(path);
+    assert(records.size() == 4);
+    assert(records[0].op == TraceOp::PUSH_BACK && records[0].arg == 0);
+    assert(records[1].op == TraceOp::PUSH_BACK && records[1].arg == 1);
+    assert(records[2].op == TraceOp::ERASE && records[2].arg == 0);
+    assert(records[3].op == TraceOp::DESTROY);
+    assert(std::all_of(records.begin(), records.end(), [&](const TraceRecord& record) {
+        return record.vector_id == records[0].vector_id;
+    }));
+
+    // Копирующее присваивание с выделением памяти — одна запись COPY, без временного вектора
+    Vector<int> from(3);
+    Vector<int> to;
+    tracer.Start(path, 16);
+    to = from;
+    assert(tracer.Stop());
+    const auto copy_records = ReadTrace(path);
+    assert(copy_records.size() == 1);
+    assert(copy_records[0].op == TraceOp::COPY && copy_records[0].arg != copy_records[0].vector_id);
+
+    // Flush во время записи из других потоков сохраняет только целые записи
+    tracer.Start(path, 64);
+    std::atomic<bool> stop = false;
+    std::thread writer([&stop] {
+        Vector<int> v;
+        while (!stop) {
+            v.PushBack(1);
+            v.PopBack();
+        }
+    });
+    for (int i = 0; i < 20; ++i) {
+        assert(tracer.Flush());
+        for (const TraceRecord& record : ReadTrace(path)) {
+            assert(record.op == TraceOp::PUSH_BACK || record.op == TraceOp::POP_BACK
+                   || record.op == TraceOp::CREATE);
+        }
+    }
+    stop = true;
+    writer.join();
+    assert(tracer.Stop());
+    std::filesystem::remove(path);
+}
+#endif
+
+void Test10() {
+    struct ThrowingMove {
+        ThrowingMove() = default;
+        ThrowingMove(const ThrowingMove&) = default;
+        ThrowingMove(ThrowingMove&&) {
+        }
+    };
+    const size_t SIZE = 10;
+    {
+        using Element = CountingType<std::string>;
+        Vector<Element> v(SIZE);
+        Element::Reset();
+        ResetAllocationStats<Element>();
+        v.Reserve(SIZE * 2);
+        assert(Element::Counts().move_constructions == SIZE);
+        assert(Element::Counts().Copies() == 0);
+        assert(Element::Counts().destructions == SIZE);
+        assert(GetAllocationStats<Element>().allocations == 1);
+    }
+    {
+        // Перемещение может бросить исключение, поэтому Reserve копирует
+        using Element = CountingType<ThrowingMove>;
+        static_assert(!std::is_nothrow_move_constructible_v<Element>);
+        Vector<Element> v(SIZE);
+        Element::Reset();
+        v.Reserve(SIZE * 2);
+        assert(Element::Counts().copy_constructions == SIZE);
+        assert(Element::Counts().Moves() == 0);
+    }
+}
+
+#if !defined(ADVANCED_VECTOR_TRACK_CAPACITY) && !defined(ADVANCED_VECTOR_TRACE)
+void Test11() {
+    constexpr auto squares = ToStaticArray<[] {
+        Vector<int> v;
+        for (int i = 0; i < 10; ++i) {
+            v.PushBack(i * i);
+        }
+        return v;
+    }>();
+    static_assert(squares.size() == 10);
+    static_assert(squares[3] == 9 && squares[9] == 81);
+
+    constexpr auto operations = [] {
+        Vector<int> v(3);
+        v.Reserve(10);
+        v.Emplace(v.begin(), 1);
+        v.Insert(v.begin() + 2, 2);
+        v.Erase(v.begin() + 1);
+        v.Resize(6);
+        Vector<int> copy(v);
+        copy.PopBack();
+        Vector<int> moved(std::move(copy));
+        v = moved;
+        return v.Size() * 100 + static_cast<size_t>(v[0] * 10 + v[1]);
+    }();
+    static_assert(operations == 512);
+}
+#endif
+
+void Test12() {
+    static_assert(std::is_same_v<BoundedVector<int, 16>, StaticVector<int, 16>>);
+    static_assert(std::is_same_v<BoundedVector<int, 1'000'000>, Vector<int>>);
+    static_assert(sizeof(StaticVector<char, 15>) == 16);
+    {
+        StaticVector<std::string, 8> v;
+        for (int i = 0; i < 7; ++i) {
+            v.PushBack(std::to_string(i));
+        }
+        v.Emplace(v.begin() + 2, "x");
+        assert(v.Size() == 8 && v[2] == "x" && v[3] == "2" && v[7] == "6");
+        v.Erase(v.begin());
+        v.PopBack();
+        assert(v.Size() == 6 && v[0] == "1" && v[5] == "5");
+
+        StaticVector<std::string, 8> other(2);
+        other.Swap(v);
+        assert(v.Size() == 2 && other.Size() == 6 && other[1] == "x");
+        v = other;
+        assert(v.Size() == 6 && v[1] == "x");
+        const StaticVector<std::string, 8> moved(std::move(other));
+        assert(moved.Size() == 6 && moved[5] == "5");
+
+        bool thrown = false;
+        try {
+            v.Resize(9);
+        }
+        catch (const std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown && v.Size() == 6);
+    }
+    {
+        using Element = CountingType<std::string>;
+        std::array<Element, 3> items = {Element("a"), Element("b"), Element("c")};
+        Element::Reset();
+        ResetAllocationStats<Element>();
+        const auto v = Vector<Element>::FromArray(std::move(items));
+        assert(v.Size() == 3 && v.Capacity() == 3 && v[2].Get() == "c");
+        assert(Element::Counts().move_constructions == 3 && Element::Counts().Copies() == 0);
+        assert(GetAllocationStats<Element>().allocations == 1);
+    }
+#if !defined(ADVANCED_VECTOR_TRACK_CAPACITY) && !defined(ADVANCED_VECTOR_TRACE)
+    constexpr int items[] = {1, 2, 3};
+    static_assert(Vector<int>::FromArray(items)[2] == 3);
+    static_assert([] {
+        StaticVector<int, 4> v(2);
+        v.Insert(v.begin(), 5);
+        v.EmplaceBack(7);
+        return v[0] + v[3];
+    }() == 12);
+#endif
+}
+
+template <typename X, typename = void>
+struct CanCount : std::false_type {};
+template <typename X>
+struct CanCount<X, std::void_t<decltype(numeric::Count(std::declval<const X&>()))>> : std::true_type {};
+
+void Test13() {
+    using namespace numeric;
+    const size_t SIZE = 100;
+    Vector<float> a(SIZE);
+    Vector<float> b(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        a[i] = static_cast<float>(i);
+        b[i] = static_cast<float>(SIZE - i);
+    }
+    const float x = 2.0f;
+    {
+        Vector<float> c = a * x + b;
+        assert(c.Size() == SIZE && c.Capacity() == SIZE);
+        assert(c[10] == 110.0f && c[99] == 199.0f);
+
+        // Вычисление на месте без новых выделений памяти
+        c = Fma(c, 0.5, -b / 2);
+        assert(c.Capacity() == SIZE && c[10] == 10.0f);
+        c = -c + View(a) * 2.0;
+        assert(c[10] == 10.0f);
+
+        Vector<float> shorter(SIZE / 2);
+        c = shorter;
+        c = a - b;
+        assert(c.Size() == SIZE && c[0] == -100.0f);
+    }
+    {
+        Vector<float> smaller = Select(Less(a, b), a, b);
+        assert(smaller[10] == 10.0f && smaller[90] == 10.0f);
+        assert(Count(Less(a, b)) == SIZE / 2);
+        assert(Count(Equal(a, 50)) == 1);
+        assert(Sum(a) == 4950.0f);
+        assert(Dot(a, b) == 166650.0f);
+        assert(Min(a - b) == -100.0f && Max(a - b) == 98.0f);
+
+        Vector<int> n(3);
+        n[0] = 7;
+        n[2] = -7;
+        Vector<int> doubled = n * 2;
+        assert(doubled[0] == 14 && doubled[1] == 0 && doubled[2] == -14);
+
+        // Дробное число не приводится к целому типу элементов
+        Vector<double> scaled = n * 2.5;
+        assert(scaled[0] == 17.5 && scaled[2] == -17.5);
+        assert(Count(Equal(n, 0.5)) == 0 && Count(Less(n, 0.5)) == 2);
+        static_assert(std::is_same_v<decltype(Sum(n * 0.5)), double>);
+        // Count считает только условия, а не сумму значений
+        static_assert(CanCount<decltype(Less(a, b))>::value);
+        static_assert(!CanCount<Vector<float>>::value && !CanCount<decltype(n * 2)>::value);
+    }
+}
+
+void Test14() {
+    Vector<int> v;
+    for (int i = 0; i < 10; ++i) {
+        v.PushBack(i);
+    }
+    {
+        const views::Span<int> span(v);
+        assert(span.Size() == 10 && span[3] == 3);
+        const views::Span<const int> tail = span.Subspan(7);
+        assert(tail.Size() == 3 && tail[0] == 7);
+    }
+    {
+        Vector<std::string> out;
+        out.PushBack("first");
+        const auto& result = v | views::Filter([](int i) {
+                                 return i % 2 == 0;
+                             })
+                             | views::Transform([](int i) {
+                                   return std::to_string(i * i);
+                               })
+                             | views::Take(3) | views::CollectInto(out);
+        assert(&result == &out);
+        assert(out.Size() == 4 && out[1] == "0" && out[3] == "16");
+    }
+    {
+        // Размер известен заранее, поэтому память выделяется один раз
+        Vector<int> out;
+        views::CollectInto(v | views::Transform([](int i) {
+                               return -i;
+                           }) | views::Take(4),
+                           out);
+        assert(out.Size() == 4 && out.Capacity() == 4 && out[3] == -3);
+
+        // Повторное дописывание удваивает ёмкость, а не выделяет память на каждый вызов
+        for (int i = 0; i < 3; ++i) {
+            views::CollectInto(v | views::Take(4), out);
+        }
+        assert(out.Size() == 16 && out.Capacity() == 16 && out[15] == 3);
+    }
+    {
+        Vector<size_t> sizes;
+        for (const auto chunk : v | views::Chunk(4)) {
+            sizes.PushBack(chunk.Size());
+        }
+        assert(sizes.Size() == 3 && sizes[0] == 4 && sizes[2] == 2);
+        assert((v | views::Chunk(5)).Size() == 2);
+    }
+    {
+        Vector<std::string> names(3);
+        int sum = 0;
+        for (auto [number, name] : views::Zip(v, names)) {
+            name = std::to_string(number);
+            sum += number;
+        }
+        assert(sum == 3 && names[2] == "2");
+        assert(views::Zip(v, names).Size() == 3);
+    }
+}
+
+namespace {
+
+    AsyncStream<std::string> Produce(Event& arrived, size_t count, size_t wait_after) {
+        for (size_t i = 0; i < count; ++i) {
+            if (i == wait_after) {
+                co_await arrived;
+            }
+            co_yield std::to_string(i);
+        }
+    }
+
+    Task Consume(AsyncStream<std::string>& stream, Vector<std::string>& out, Vector<size_t>& batches) {
+        while (size_t collected = co_await stream.CollectInto(out, 3)) {
+            batches.PushBack(collected);
+        }
+    }
+
+    AsyncStream<int> Fail() {
+        co_yield 1;
+        throw std::runtime_error("stream failed");
+    }
+
+    Task ConsumeFailing(AsyncStream<int>& stream, Vector<int>& out) {
+        co_await stream.CollectInto(out, 10);
+    }
+
+}  // namespace
+
+void Test15() {
+    {
+        Event arrived;
+        AsyncStream<std::string> stream = Produce(arrived, 10, 5);
+        Vector<std::string> out;
+        Vector<size_t> batches;
+        const Task consumer = Consume(stream, out, batches);
+        // Производитель ждёт данных посреди второй пачки
+        assert(!consumer.Done() && batches.Size() == 1 && out.Size() == 5);
+        arrived.Set();
+        assert(consumer.Done() && stream.Done());
+        consumer.Get();
+        assert(out.Size() == 10 && out[9] == "9");
+        assert(batches.Size() == 4 && batches[1] == 3 && batches[3] == 1);
+    }
+    {
+        AsyncStream<int> stream = Fail();
+        Vector<int> out;
+        const Task consumer = ConsumeFailing(stream, out);
+        assert(consumer.Done() && out.Size() == 1);
+        bool thrown = false;
+        try {
+            consumer.Get();
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+void Test16() {
+    const int SIZE = 100'000;
+    const auto make_data = [] {
+        Vector<int> data;
+        data.Reserve(SIZE);
+        for (int i = 0; i < SIZE; ++i) {
+            data.PushBack(i);
+        }
+        return data;
+    };
+    for (const bool threaded : {false, true}) {
+        int64_t sum = 0;
+        size_t chunks = 0;
+        Pipeline<int> pipeline(4096);
+        pipeline.AddTransform([](int& i) {
+                    i *= 3;
+                })
+            .AddFilter([](int i) {
+                return i % 2 == 0;
+            })
+            .AddStage([&sum, &chunks](views::Span<int> chunk) {
+                for (int i : chunk) {
+                    sum += i;
+                }
+                ++chunks;
+                return chunk.Size();
+            });
+        assert(pipeline.ChunkSize() == 1024);
+
+        Vector<int> data = make_data();
+        if (threaded) {
+            pipeline.RunThreaded(data, 2);
+        }
+        else {
+            pipeline.Run(data);
+        }
+        assert(data.Size() == SIZE / 2 && data[0] == 0 && data[1] == 6 && data[SIZE / 2 - 1] == (SIZE - 2) * 3);
+        assert(sum == int64_t(3) * (SIZE / 2) * (SIZE / 2 - 1));
+        assert(chunks == (SIZE + 1023) / 1024);
+    }
+    {
+        Pipeline<int> pipeline(4096);
+        pipeline.AddTransform([](int&) {})
+            .AddTransform([](int& i) {
+                if (i == SIZE / 2) {
+                    throw std::runtime_error("bad element");
+                }
+            })
+            .AddTransform([](int&) {});
+        Vector<int> data = make_data();
+        bool thrown = false;
+        try {
+            pipeline.RunThreaded(data);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+}
+
+void Test17() {
+    const size_t ROWS = 37;
+    const size_t COLS = 70;
+    Vector<float> v(ROWS * COLS);
+    for (size_t i = 0; i < v.Size(); ++i) {
+        v[i] = static_cast<float>(i);
+    }
+    const MatrixView<float> m(v, ROWS, COLS);
+    assert(m(2, 3) == 2 * COLS + 3);
+    assert(m.Row(1).Size() == COLS && m.Row(1)[0] == COLS);
+    float col_sum = 0;
+    for (float x : m.Col(5)) {
+        col_sum += x;
+    }
+    assert(m.Col(5).Size() == ROWS && col_sum == COLS * (ROWS * (ROWS - 1) / 2) + 5 * ROWS);
+
+    const MatrixView<float> block = m.Block(10, 20, 5, 6);
+    assert(!block.IsContiguous() && block(1, 2) == 11 * COLS + 22);
+    block(0, 0) = -1;
+    assert(v[10 * COLS + 20] == -1);
+    v[10 * COLS + 20] = 10 * COLS + 20;
+
+    const MatrixView<float> reshaped = m.Reshape(COLS, ROWS);
+    assert(reshaped(1, 0) == ROWS);
+
+    const Vector<float> t = Transposed(v, ROWS, COLS);
+    const MatrixView<const float> tm(t, COLS, ROWS);
+    for (size_t i = 0; i < ROWS; ++i) {
+        for (size_t j = 0; j < COLS; ++j) {
+            assert(tm(j, i) == m(i, j));
+        }
+    }
+
+    Vector<int> ints(ROWS * COLS);
+    for (size_t i = 0; i < ints.Size(); ++i) {
+        ints[i] = static_cast<int>(i);
+    }
+    Vector<int> block_t(5 * 6);
+    Transpose(MatrixView<int>(ints, ROWS, COLS).Block(3, 4, 5, 6), MatrixView<int>(block_t, 6, 5));
+    assert(block_t[0] == static_cast<int>(3 * COLS + 4) && block_t[5 * 6 - 1] == static_cast<int>(7 * COLS + 9));
+}
+
+void Test18() {
+    const size_t SIZE = 1000;
+    Vector<int> data(SIZE);
+    Vector<uint32_t> indices(SIZE * 2);
+    for (size_t i = 0; i < SIZE; ++i) {
+        data[i] = static_cast<int>(i * 10);
+    }
+    for (size_t i = 0; i < indices.Size(); ++i) {
+        indices[i] = static_cast<uint32_t>(i * 7919 % SIZE);
+    }
+    for (const size_t distance : {size_t(0), size_t(4), SIZE * 4}) {
+        Vector<int> out(3);
+        Gather(data, indices, out, distance);
+        assert(out.Size() == indices.Size());
+        for (size_t i = 0; i < out.Size(); ++i) {
+            assert(out[i] == data[indices[i]]);
+        }
+    }
+
+    Vector<const int*> pointers(SIZE);
+    for (size_t i = 0; i < SIZE; ++i) {
+        pointers[i] = &data[indices[i]];
+    }
+    int64_t sum = 0;
+    for (const int* item : Prefetching(pointers, 8)) {
+        sum += *item;
+    }
+    assert(sum == int64_t(10) * SIZE * (SIZE - 1) / 2);
+    size_t count = 0;
+    for (auto it = PrefetchingIterator<const int* const>(pointers.begin() + 995, pointers.end(), 8);
+         it != PrefetchingIterator<const int* const>(pointers.end(), pointers.end()); ++it) {
+        ++count;
+    }
+    assert(count == 5);
+}
+
+void Test19() {
+    const size_t SIZE = 100000;
+    Vector<float> data(SIZE);
+    Vector<uint32_t> indices(SIZE + 13);
+    for (size_t i = 0; i < SIZE; ++i) {
+        data[i] = static_cast<float>(i);
+    }
+    for (size_t i = 0; i < indices.Size(); ++i) {
+        indices[i] = static_cast<uint32_t>(i * 7919 % SIZE);
+    }
+    Vector<float> out;
+    Gather(data, indices, out);
+    assert(out.Size() == indices.Size());
+    for (size_t i = 0; i < out.Size(); ++i) {
+        assert(out[i] == data[indices[i]]);
+    }
+    for (const size_t threads : {size_t(1), size_t(4)}) {
+        Vector<float> parallel(5);
+        ParallelGather(data, indices, parallel, threads);
+        assert(parallel.Size() == out.Size());
+        assert(std::equal(parallel.begin(), parallel.end(), out.begin()));
+    }
+
+    // Повторяющиеся индексы: каждый элемент получает несколько слагаемых
+    Vector<int> values(indices.Size());
+    Vector<uint32_t> repeated(indices.Size());
+    for (size_t i = 0; i < values.Size(); ++i) {
+        values[i] = static_cast<int>(i % 17) - 8;
+        repeated[i] = indices[i] % 1000;
+    }
+    Vector<int> expected(SIZE);
+    for (size_t i = 0; i < values.Size(); ++i) {
+        expected[repeated[i]] += values[i];
+    }
+    Vector<int> sums(SIZE);
+    ScatterAdd(sums, repeated, values);
+    assert(std::equal(sums.begin(), sums.end(), expected.begin()));
+    Vector<int> grouped(SIZE);
+    ScatterAddGrouped(grouped, repeated, values);
+    assert(std::equal(grouped.begin(), grouped.end(), expected.begin()));
+    Vector<int> parallel(SIZE);
+    ParallelScatterAdd(parallel, repeated, values, 4);
+    assert(std::equal(parallel.begin(), parallel.end(), expected.begin()));
+
+    // Для чисел с плавающей точкой все варианты складывают в одном порядке
+    Vector<float> float_values(indices.Size());
+    for (size_t i = 0; i < float_values.Size(); ++i) {
+        float_values[i] = 1.0f / static_cast<float>(i + 1);
+    }
+    Vector<float> float_sums(SIZE);
+    Vector<float> float_grouped(SIZE);
+    Vector<float> float_parallel(SIZE);
+    ScatterAdd(float_sums, indices, float_values);
+    ScatterAddGrouped(float_grouped, indices, float_values);
+    ParallelScatterAdd(float_parallel, indices, float_values, 3);
+    assert(std::equal(float_sums.begin(), float_sums.end(), float_grouped.begin()));
+    assert(std::equal(float_sums.begin(), float_sums.end(), float_parallel.begin()));
+}
+
+void Test20() {
+    using namespace std::literals;
+    const Vector<int> empty;
+    const Vector<int> a = Vector<int>::FromArray({1, 2, 3});
+    const Vector<int> b = Vector<int>::FromArray({1, 2, 4});
+    const Vector<int> prefix = Vector<int>::FromArray({1, 2});
+    assert(a == a && a != b && a != prefix && empty == Vector<int>());
+    assert(a < b && prefix < a && empty < prefix && !(a < a));
+    assert(b > a && a <= a && a >= prefix);
+    // Порядок чисел, а не байтов: в little-endian у 256 младший байт меньше, чем у 1
+    assert(Vector<int>::FromArray({1}) < Vector<int>::FromArray({256}));
+    assert(Vector<int>::FromArray({-1}) < Vector<int>::FromArray({0}));
+
+    // Различие далеко за первым блоком memcmp
+    Vector<uint16_t> long_lhs(1000);
+    Vector<uint16_t> long_rhs(1000);
+    assert(long_lhs == long_rhs && long_lhs.Hash() == long_rhs.Hash());
+    long_rhs[777] = 1;
+    assert(long_lhs != long_rhs && long_lhs < long_rhs && long_lhs.Hash() != long_rhs.Hash());
+
+    // Не побайтно сравнимые элементы: 0.0 == -0.0 при разных байтах
+    const Vector<double> zeros = Vector<double>::FromArray({0.0, 1.5});
+    const Vector<double> negative_zeros = Vector<double>::FromArray({-0.0, 1.5});
+    assert(zeros == negative_zeros && zeros.Hash() == negative_zeros.Hash());
+    const Vector<std::string> words = Vector<std::string>::FromArray({"apple"s, "pear"s});
+    assert(words < Vector<std::string>::FromArray({"apple"s, "plum"s}));
+
+    std::unordered_set<Vector<int>> set;
+    for (size_t size = 0; size < 100; ++size) {
+        Vector<int> v(size);
+        for (size_t i = 0; i < size; ++i) {
+            v[i] = static_cast<int>(i * i);
+        }
+        assert(set.insert(v).second);
+    }
+    assert(set.size() == 100);
+    assert(set.count(a) == 0);
+    assert(set.count(Vector<int>::FromArray({0, 1, 4})) == 1);
+}
+
+void Test21() {
+    using namespace std::literals;
+    Vector<uint32_t> v = Vector<uint32_t>::FromArray({1, 1, 2, 3, 3, 3, 7, 9, 9});
+    Unique(v);
+    assert(v == Vector<uint32_t>::FromArray({1, 2, 3, 7, 9}));
+    Vector<std::string> words = Vector<std::string>::FromArray({"a"s, "a"s, "b"s});
+    Unique(words);
+    assert(words.Size() == 2 && words[1] == "b"s);
+
+    // Сравнение с алгоритмами стандартной библиотеки на множествах разной плотности и длины,
+    // включая сильно различающиеся по длине (экспоненциальный поиск)
+    const auto make_set = [](size_t size, uint32_t step, uint32_t offset) {
+        Vector<uint32_t> set;
+        for (size_t i = 0; i < size; ++i) {
+            set.PushBack(offset + static_cast<uint32_t>(i) * step + static_cast<uint32_t>(i * i % 3));
+        }
+        Unique(set);
+        return set;
+    };
+    const auto check = [](const Vector<uint32_t>& a, const Vector<uint32_t>& b) {
+        Vector<uint32_t> out = Vector<uint32_t>::FromArray({42});
+        std::vector<uint32_t> expected;
+        Intersect(a, b, out);
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        assert(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+        // Ещё одна ячейка — для элементов, которые пишутся без ветвления и отбрасываются
+        assert(out.Capacity() == std::min(a.Size(), b.Size()) + 1);
+        expected.clear();
+        Union(a, b, out);
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        assert(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+        expected.clear();
+        Difference(a, b, out);
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        assert(std::equal(out.begin(), out.end(), expected.begin(), expected.end()));
+    };
+    for (const size_t a_size : {size_t(0), size_t(3), size_t(100), size_t(5000)}) {
+        for (const size_t b_size : {size_t(0), size_t(1), size_t(7), size_t(100), size_t(5000)}) {
+            for (const uint32_t step : {1u, 2u, 5u}) {
+                const Vector<uint32_t> a = make_set(a_size, 2, 0);
+                const Vector<uint32_t> b = make_set(b_size, step, 3);
+                check(a, b);
+                check(b, a);
+            }
+        }
+    }
+    // Весь короткий вектор совпал, а в блоке длинного ещё остались элементы
+    check(Vector<uint32_t>::FromArray({1, 2, 3, 5, 10, 11, 12, 13}), Vector<uint32_t>::FromArray({1, 2, 3, 10}));
+    check(Vector<uint32_t>::FromArray({1, 2, 3, 4}), Vector<uint32_t>::FromArray({1, 2, 3, 4, 5, 6, 7, 8}));
+}
+
+void Test22() {
+    // Длины вокруг границы блока SSE и участка потока
+    for (const size_t size : {size_t(0), size_t(1), size_t(5), size_t(1000), size_t(300001)}) {
+        Vector<int> in(size);
+        for (size_t i = 0; i < size; ++i) {
+            in[i] = static_cast<int>(i * 7919 % 13) - 6;
+        }
+        std::vector<int> inclusive(size);
+        std::vector<int> exclusive(size);
+        std::inclusive_scan(in.begin(), in.end(), inclusive.begin());
+        std::exclusive_scan(in.begin(), in.end(), exclusive.begin(), 100);
+        const int total = std::accumulate(in.begin(), in.end(), 0);
+
+        Vector<int> out(3);
+        assert(InclusiveScan(in, out) == total);
+        assert(std::equal(out.begin(), out.end(), inclusive.begin(), inclusive.end()));
+        assert(ExclusiveScan(in, out, 100) == total + 100);
+        assert(std::equal(out.begin(), out.end(), exclusive.begin(), exclusive.end()));
+        for (const size_t threads : {size_t(1), size_t(3)}) {
+            assert(ParallelInclusiveScan(in, out, threads) == total);
+            assert(std::equal(out.begin(), out.end(), inclusive.begin(), inclusive.end()));
+            assert(ParallelExclusiveScan(in, out, 100, threads) == total + 100);
+            assert(std::equal(out.begin(), out.end(), exclusive.begin(), exclusive.end()));
+        }
+        // На месте
+        Vector<int> v = in;
+        ParallelExclusiveScan(v, v, 100, 4);
+        assert(std::equal(v.begin(), v.end(), exclusive.begin(), exclusive.end()));
+        v = in;
+        InclusiveScan(v, v);
+        assert(std::equal(v.begin(), v.end(), inclusive.begin(), inclusive.end()));
+    }
+
+    // Для float порядок сложения другой, но на точно представимых значениях результат совпадает
+    Vector<float> halves(1001);
+    for (size_t i = 0; i < halves.Size(); ++i) {
+        halves[i] = static_cast<float>(i % 4) * 0.5f;
+    }
+    Vector<float> float_out;
+    ExclusiveScan(halves, float_out);
+    float expected = 0.0f;
+    for (size_t i = 0; i < halves.Size(); ++i) {
+        assert(float_out[i] == expected);
+        expected += halves[i];
+    }
+    Vector<uint64_t> wide = Vector<uint64_t>::FromArray({1, 2, 3});
+    ExclusiveScan(wide, wide);
+    assert(wide == Vector<uint64_t>::FromArray({0, 1, 3}));
+
+    const size_t SIZE = 200000;
+    Vector<uint16_t> keys(SIZE);
+    std::vector<size_t> expected_counts(500);
+    for (size_t i = 0; i < SIZE; ++i) {
+        keys[i] = static_cast<uint16_t>(i < SIZE / 2 ? 7 : i * 31 % 500);
+        ++expected_counts[keys[i]];
+    }
+    Vector<size_t> counts(2);
+    Histogram(keys, 500, counts);
+    assert(std::equal(counts.begin(), counts.end(), expected_counts.begin(), expected_counts.end()));
+    ParallelHistogram(keys, 500, counts, 3);
+    assert(std::equal(counts.begin(), counts.end(), expected_counts.begin(), expected_counts.end()));
+    Histogram(keys, 5000, counts);
+    assert(counts.Size() == 5000 && std::equal(expected_counts.begin(), expected_counts.end(), counts.begin()));
+
+    const Vector<double> values = Vector<double>::FromArray({-1.0, 0.0, 0.5, 2.49, 2.5, 9.99, 10.0, 42.0});
+    Histogram(values, 0.0, 10.0, 4, counts);
+    assert(counts == Vector<size_t>::FromArray({3, 1, 0, 1}));
+    ParallelHistogram(values, 0.0, 10.0, 4, counts);
+    assert(counts == Vector<size_t>::FromArray({3, 1, 0, 1}));
+}
+
+void Test23() {
+    using namespace std::literals;
+    // Отдельный пул, чтобы рабочие потоки были и на одноядерной машине
+    ThreadPool pool(3);
+    std::atomic<size_t> sum = 0;
+    pool.Run(1000, [&](size_t index) {
+        sum += index;
+    });
+    assert(sum == 999 * 1000 / 2);
+    try {
+        pool.Run(100, [](size_t index) {
+            if (index == 42) {
+                throw std::runtime_error("task failed"s);
+            }
+        });
+        assert(false);
+    }
+    catch (const std::runtime_error& e) {
+        assert(e.what() == "task failed"s);
+    }
+    // Вложенный вызов выполняется в текущем потоке и не ждёт занятых рабочих
+    sum = 0;
+    pool.Run(8, [&](size_t) {
+        pool.Run(8, [&](size_t) {
+            ++sum;
+        });
+    });
+    assert(sum == 64);
+
+    // Размеры вокруг порогов параллельного копирования и записи в обход кэша,
+    // приёмник со смещением от границы строки кэша
+    for (const size_t size : {size_t(0), size_t(3), PARALLEL_COPY_BYTES + 13, NON_TEMPORAL_COPY_BYTES + 7}) {
+        Vector<unsigned char> from(size);
+        for (size_t i = 0; i < size; ++i) {
+            from[i] = static_cast<unsigned char>(i * 7919 >> 3);
+        }
+        for (const size_t threads : {size_t(1), size_t(4)}) {
+            Vector<unsigned char> to(size + 5);
+            ParallelCopy(from.begin(), size, to.begin() + 5, threads);
+            assert(std::equal(from.begin(), from.end(), to.begin() + 5));
+        }
+        Vector<unsigned char> copy(7);
+        ParallelAssign(copy, from);
+        assert(copy == from);
+        ParallelAppend(copy, from);
+        assert(copy.Size() == 2 * size && std::equal(from.begin(), from.end(), copy.begin() + size));
+        ParallelAppend(copy, copy);
+        assert(copy.Size() == 4 * size && std::equal(from.begin(), from.end(), copy.begin() + 3 * size));
+    }
+
+    // Тривиально копируемые элементы с инициализаторами членов тоже копируются параллельно
+    struct Pixel {
+        uint8_t rgba[4] = {0, 0, 0, 255};
+    };
+    static_assert(!std::is_trivial_v<Pixel> && std::is_trivially_copyable_v<Pixel>);
+    Vector<Pixel> pixels(PARALLEL_COPY_BYTES / sizeof(Pixel) + 3);
+    pixels[7].rgba[0] = 7;
+    Vector<Pixel> pixels_copy;
+    ParallelAssign(pixels_copy, pixels, 4);
+    ParallelAppend(pixels_copy, pixels, 4);
+    assert(pixels_copy.Size() == 2 * pixels.Size());
+    assert(pixels_copy[pixels.Size() + 7].rgba[0] == 7 && pixels_copy.end()[-1].rgba[3] == 255);
+
+    // Нетривиальные элементы копируются обычным образом
+    const Vector<std::string> words = Vector<std::string>::FromArray({"a"s, std::string(40, 'b')});
+    Vector<std::string> text;
+    ParallelAssign(text, words);
+    ParallelAppend(text, text);
+    assert(text.Size() == 4 && text[3] == words[1] && text[2] == words[0]);
+}
+
+void Test24() {
+    using namespace std::literals;
+    // Значения с равными и разными байтами, длины вокруг размера блока заполнения
+    struct Triple {
+        int a = 0;
+        int b = 0;
+        int c = 0;
+    };
+    for (const size_t size : {size_t(0), size_t(5), size_t(64), size_t(1000)}) {
+        Vector<int> ints(size, 0x01020304);
+        assert(ints.Size() == size && std::count(ints.begin(), ints.end(), 0x01020304) == static_cast<ptrdiff_t>(size));
+        ints.Assign(size + 3, -1);
+        assert(ints.Size() == size + 3 && std::count(ints.begin(), ints.end(), -1) == static_cast<ptrdiff_t>(size + 3));
+        ints.Resize(2 * size + 7, 42);
+        assert(ints.Size() == 2 * size + 7 && ints[size + 2] == -1);
+        assert(std::count(ints.begin(), ints.end(), 42) == static_cast<ptrdiff_t>(size + 4));
+
+        Vector<Triple> triples(2);
+        triples.Resize(size + 2, Triple{1, 2, 3});
+        assert(std::all_of(triples.begin() + 2, triples.end(), [](const Triple& t) {
+            return t.a == 1 && t.b == 2 && t.c == 3;
+        }));
+        assert(triples[0].a == 0 && triples[1].c == 0);
+    }
+
+    // value — элемент самого вектора, в том числе при перевыделении памяти
+    Vector<int> v = Vector<int>::FromArray({7, 8, 9});
+    v.Resize(100, v[1]);
+    assert(v.Size() == 100 && v[2] == 9 && v[3] == 8 && v[99] == 8);
+    v.Assign(500, v[0]);
+    assert(v.Size() == 500 && std::count(v.begin(), v.end(), 7) == 500);
+    v.Assign(3, v[499]);
+    assert(v.Size() == 3 && v.Capacity() == 500 && v[2] == 7);
+    v.Resize(1, 0);
+    assert(v.Size() == 1 && v[0] == 7);
+
+    Vector<std::string> words(1, std::string(30, 'x'));
+    words.Resize(4, words[0]);
+    assert(words.Size() == 4 && words[3] == std::string(30, 'x'));
+    words.Assign(2, "y"s);
+    assert(words.Size() == 2 && words[0] == "y" && words[1] == "y");
+    words.Assign(5, words[1]);
+    assert(words.Size() == 5 && words[4] == "y");
+
+#if !defined(ADVANCED_VECTOR_TRACK_CAPACITY) && !defined(ADVANCED_VECTOR_TRACE)
+    static_assert([] {
+        Vector<int> filled(3, 4);
+        filled.Resize(5, 6);
+        filled.Assign(2, filled[4]);
+        return filled.Size() * 10 + static_cast<size_t>(filled[1]);
+    }() == 26);
+#endif
+}
+
+void Test25() {
+    using Element = CountingType<std::string>;
+    const size_t STEP = 2;
+    IncrementalVector<Element> v(STEP);
+    std::vector<std::string> expected;
+    Element::Reset();
+    for (size_t i = 0; i < 1000; ++i) {
+        const size_t moves = Element::Counts().move_constructions;
+        v.EmplaceBack(std::to_string(i));
+        expected.push_back(std::to_string(i));
+        // Ни одна вставка не переносит больше STEP элементов
+        assert(Element::Counts().move_constructions - moves <= STEP);
+        if (i % 97 == 0) {
+            for (size_t j = 0; j < v.Size(); ++j) {
+                assert(v[j].Get() == expected[j]);
+            }
+        }
+    }
+    assert(Element::Counts().Copies() == 0);
+
+    // Удаление в середине переноса, в том числе элементов ещё в старом блоке: после 600 вставок
+    // с шагом 1 перенесены 88 из 512 элементов
+    IncrementalVector<Element> partial(1);
+    expected.clear();
+    for (size_t i = 0; i < 600; ++i) {
+        partial.EmplaceBack(std::to_string(i));
+        expected.push_back(std::to_string(i));
+    }
+    assert(partial.IsMigrating());
+    for (size_t i = 0; i < 100; ++i) {
+        partial.PopBack();
+        expected.pop_back();
+    }
+    assert(partial.IsMigrating());
+    size_t index = 0;
+    partial.ForEach([&](const Element& item) {
+        assert(item.Get() == expected[index++]);
+    });
+    assert(index == partial.Size() && partial.Size() == 500);
+    v = std::move(partial);
+
+    IncrementalVector<Element> moved(std::move(v));
+    assert(v.Size() == 0 && moved.Size() == expected.size());
+    moved.FinishMigration();
+    assert(!moved.IsMigrating() && moved[moved.Size() - 1].Get() == expected.back());
+    moved.Reserve(5000);
+    assert(moved.Capacity() == 5000 && moved[10].Get() == "10");
+    moved.Clear();
+    assert(moved.Size() == 0);
+    const OperationCounts counts = Element::Counts();
+    assert(counts.destructions == counts.constructions + counts.copy_constructions + counts.move_constructions);
+}
+
+void Test26() {
+    PregrowingVector<int> v;
+    size_t capacity = 0;
+    bool pregrown = false;
+    for (int i = 0; i < 1'000'000; ++i) {
+        v.PushBack(i);
+        if (v.Capacity() != capacity) {
+            // Каждый крупный блок после первого был подготовлен заранее
+            assert(v.Capacity() == std::max<size_t>(capacity * 2, 1) && !v.HasNextBlock());
+            capacity = v.Capacity();
+        }
+        if (v.Size() * 4 >= v.Capacity() * 3 && v.Capacity() * sizeof(int) * 2 >= PregrowingVector<int>::PREGROW_MIN_BYTES) {
+            assert(v.HasNextBlock());
+            pregrown = true;
+        }
+    }
+    assert(pregrown);
+    for (int i = 0; i < 1'000'000; i += 999) {
+        assert(v[i] == i);
+    }
+    v.PopBack();
+    assert(v.Size() == 999'999 && *(v.end() - 1) == 999'998);
+
+    // Подготовленный блок меньше запрошенного в Reserve: выделяется новый
+    PregrowingVector<std::string> words(0.5);
+    words.Reserve(40'000);
+    for (size_t i = 0; i < 30'000; ++i) {
+        words.EmplaceBack(std::to_string(i));
+    }
+    assert(words.HasNextBlock());
+    words.Reserve(500'000);
+    assert(words.Capacity() == 500'000 && words[29'999] == "29999" && !words.HasNextBlock());
+    words.Clear();
+    assert(words.Size() == 0 && words.begin() == words.end());
+}
+
+void Test27() {
+    // Элементы разрушаются в другом потоке, поэтому живые копии считает атомарный счётчик shared_ptr
+    const auto token = std::make_shared<int>(42);
+    const size_t SIZE = 10'000;
+    {
+        // Очередь на один вектор: Destroy ждёт, пока фоновый поток освободит место
+        Reclaimer reclaimer(1);
+        for (int round = 0; round < 5; ++round) {
+            Vector<std::shared_ptr<int>> v(SIZE, token);
+            reclaimer.Destroy(std::move(v));
+            assert(v.Size() == 0 && v.Capacity() == 0);
+        }
+        reclaimer.Flush();
+        assert(token.use_count() == 1);
+
+        // Маленький вектор разрушается сразу
+        Vector<std::shared_ptr<int>> small(3, token);
+        reclaimer.Destroy(std::move(small));
+        assert(token.use_count() == 1);
+
+        // Оставшееся в очереди разрушает деструктор Reclaimer
+        Vector<std::shared_ptr<int>> last(SIZE, token);
+        reclaimer.Destroy(std::move(last));
+    }
+    assert(token.use_count() == 1);
+
+    {
+        // Flush ждёт только векторы, переданные до вызова, и возвращается, пока другой поток продолжает их передавать
+        Reclaimer reclaimer(2);
+        std::atomic<bool> stop = false;
+        std::thread producer([&reclaimer, &stop] {
+            const auto other = std::make_shared<int>(0);
+            while (!stop) {
+                reclaimer.Destroy(Vector<std::shared_ptr<int>>(SIZE, other));
+            }
+        });
+        for (int round = 0; round < 10; ++round) {
+            reclaimer.Destroy(Vector<std::shared_ptr<int>>(SIZE, token));
+            reclaimer.Flush();
+            assert(token.use_count() == 1);
+        }
+        stop = true;
+        producer.join();
+    }
+
+    Vector<std::string> words(100'000, std::string(30, 'x'));
+    DeferredDestroy(std::move(words));
+    DefaultReclaimer().Flush();
+    assert(words.Size() == 0);
+}
+
+void Test28() {
+    RcuVector<int> table(Vector<int>::FromArray({1, 2, 3}), 2);
+    auto reader = table.RegisterReader();
+    {
+        const auto snapshot = reader.Read();
+        table.Update([](Vector<int>& v) {
+            v.PushBack(4);
+        });
+        // Старый вектор ещё читается и не разрушен
+        assert(snapshot->Size() == 3 && (*snapshot)[2] == 3);
+        assert(table.Reclaim() == 1);
+    }
+    assert(table.Reclaim() == 0);
+    assert(reader.Read()->Size() == 4);
+
+    {
+        auto second = table.RegisterReader();
+        bool thrown = false;
+        try {
+            table.RegisterReader();
+        }
+        catch (const std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+    auto third = table.RegisterReader();
+
+    // Читатели проверяют, что каждый снимок цел: все элементы версии v равны v, и их v штук
+    RcuVector<int> versions(Vector<int>(1, 1), 8);
+    std::atomic<bool> stop = false;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&versions, &stop] {
+            auto thread_reader = versions.RegisterReader();
+            int last = 0;
+            while (!stop) {
+                const auto snapshot = thread_reader.Read();
+                const int version = (*snapshot)[0];
+                assert(version >= last && snapshot->Size() == static_cast<size_t>(version));
+                assert(std::count(snapshot->begin(), snapshot->end(), version) == version);
+                last = version;
+            }
+        });
+    }
+    for (int version = 2; version <= 300; ++version) {
+        versions.Publish(Vector<int>(version, version));
+    }
+    stop = true;
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    assert(versions.Reclaim() == 0);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+void Test29() {
+    const std::string name = "/advanced_vector_test_" + std::to_string(getpid());
+    const size_t size = 10000;
+    {
+        Vector<uint64_t> values(size - 1);
+        std::iota(values.begin(), values.end(), 0);
+        auto loaded = SharedMemoryVector<uint64_t>::Create(name, size);
+        loaded.Append(values.begin(), values.Size());
+        loaded.Mutable(0) = size;
+        assert(loaded[0] == size);
+        loaded.Mutable(0) = 0;
+
+        // Незапечатанный сегмент читатели не принимают
+        bool thrown = false;
+        try {
+            SharedMemoryVector<uint64_t>::Open(name);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        loaded.PushBack(size - 1);
+        thrown = false;
+        try {
+            loaded.PushBack(0);
+        }
+        catch (const std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown && loaded.Size() == size);
+        loaded.Seal();
+        assert(loaded.IsSealed());
+        thrown = false;
+        try {
+            loaded.Mutable(0) = 1;
+        }
+        catch (const std::logic_error&) {
+            thrown = true;
+        }
+        assert(thrown && loaded[0] == 0);
+    }
+
+    // Загрузчик закрыл сегмент, данные остаются до Unlink
+    const auto shared = SharedMemoryVector<uint64_t>::Open(name);
+    assert(shared.Size() == size && shared.Capacity() == size);
+    const uint64_t expected = size * (size - 1) / 2;
+    assert(std::accumulate(shared.begin(), shared.end(), uint64_t{0}) == expected);
+
+    // Другой процесс отображает тот же сегмент по своему адресу
+    const pid_t child = fork();
+    assert(child >= 0);
+    if (child == 0) {
+        // Неконстантный объект тоже читается через operator[]
+        auto mapped = SharedMemoryVector<uint64_t>::Open(name);
+        const bool same = mapped[size - 1] == size - 1
+                          && std::accumulate(mapped.begin(), mapped.end(), uint64_t{0}) == expected;
+        _exit(same ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    bool thrown = false;
+    try {
+        SharedMemoryVector<uint32_t>::Open(name);
+    }
+    catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    // Размер в заголовке больше ёмкости: такой сегмент не открывается. Размер — шестое 8-байтовое поле заголовка
+    {
+        const int fd = shm_open(name.c_str(), O_RDWR, 0);
+        assert(fd >= 0);
+        void* address = mmap(nullptr, 64, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        assert(address != MAP_FAILED);
+        static_cast<uint64_t*>(address)[5] = size + 1;
+        thrown = false;
+        try {
+            SharedMemoryVector<uint64_t>::Open(name);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        static_cast<uint64_t*>(address)[5] = size;
+        munmap(address, 64);
+    }
+
+    SharedMemoryVector<uint64_t>::Unlink(name);
+    thrown = false;
+    try {
+        SharedMemoryVector<uint64_t>::Open(name);
+    }
+    catch (const std::system_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(shared[size - 1] == size - 1);
+
+    // Размер сегмента не помещается в size_t: сегмент не создаётся
+    thrown = false;
+    try {
+        SharedMemoryVector<uint64_t>::Create(name, SIZE_MAX / 4);
+    }
+    catch (const std::length_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    SharedMemoryVector<uint64_t>::Create(name, 1);
+    SharedMemoryVector<uint64_t>::Unlink(name);
+}
+#endif
+
+int main() {
+    try {
+        Test1();
+        Test2();
+        Test3();
+        Test4();
+        Test5();
+        Test6();
+        Test7();
+        Test10();
+        Test12();
+        Test13();
+        Test14();
+        Test15();
+        Test16();
+        Test17();
+        Test18();
+        Test19();
+        Test20();
+        Test21();
+        Test22();
+        Test23();
+        Test24();
+        Test25();
+        Test26();
+        Test27();
+        Test28();
+#if defined(__unix__) || defined(__APPLE__)
+        Test29();
+#endif
+#if !defined(ADVANCED_VECTOR_TRACK_CAPACITY) && !defined(ADVANCED_VECTOR_TRACE)
+        Test11();
+#endif
+#ifdef ADVANCED_VECTOR_TRACK_CAPACITY
+        Test8();
+#endif
+#ifdef ADVANCED_VECTOR_TRACE
+        Test9();
+#endif
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,237 @@
+#pragma once
+#include "vector.h"
+#include "views.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+// Элементы с постоянным шагом, например столбец матрицы
+template <typename T>
+class StridedSpan {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::remove_cv_t<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = T*;
+        using reference = T&;
+
+        iterator() = default;
+        iterator(T* data, size_t index, size_t stride) noexcept
+            : data_(data)
+            , index_(index)
+            , stride_(stride) {
+        }
+
+        T& operator*() const noexcept {
+            return data_[index_ * stride_];
+        }
+
+        iterator& operator++() noexcept {
+            ++index_;
+            return *this;
+        }
+        iterator operator++(int) noexcept {
+            iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const iterator& other) const noexcept {
+            return index_ == other.index_;
+        }
+        bool operator!=(const iterator& other) const noexcept {
+            return index_ != other.index_;
+        }
+
+    private:
+        // Позиция хранится номером: указатель на элемент за последним при stride > 1
+        // вышел бы за пределы массива
+        T* data_ = nullptr;
+        size_t index_ = 0;
+        size_t stride_ = 0;
+    };
+
+    StridedSpan(T* data, size_t size, size_t stride) noexcept
+        : data_(data)
+        , size_(size)
+        , stride_(stride) {
+    }
+
+    iterator begin() const noexcept {
+        return iterator(data_, 0, stride_);
+    }
+    iterator end() const noexcept {
+        return iterator(data_, size_, stride_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index * stride_];
+    }
+
+private:
+    T* data_;
+    size_t size_;
+    size_t stride_;
+};
+
+// Невладеющее представление матрицы rows x cols, хранящейся по строкам. Строки отстоят друг от друга
+// на stride элементов, поэтому подматрица (Block) — тоже MatrixView над теми же элементами.
+// Для матрицы только для чтения используется MatrixView<const T>
+template <typename T>
+class MatrixView {
+public:
+    using value_type = std::remove_cv_t<T>;
+
+    MatrixView(T* data, size_t rows, size_t cols, size_t stride) noexcept
+        : data_(data)
+        , rows_(rows)
+        , cols_(cols)
+        , stride_(stride) {
+        assert(stride >= cols);
+    }
+
+    MatrixView(Vector<value_type>& v, size_t rows, size_t cols) noexcept
+        : MatrixView(v.begin(), rows, cols, cols) {
+        assert(rows * cols == v.Size());
+    }
+
+    template <typename U = T, std::enable_if_t<std::is_const_v<U>, int> = 0>
+    MatrixView(const Vector<value_type>& v, size_t rows, size_t cols) noexcept
+        : MatrixView(v.begin(), rows, cols, cols) {
+        assert(rows * cols == v.Size());
+    }
+
+    template <typename U = T, std::enable_if_t<std::is_const_v<U>, int> = 0>
+    MatrixView(MatrixView<value_type> other) noexcept
+        : MatrixView(other.Data(), other.Rows(), other.Cols(), other.Stride()) {
+    }
+
+    size_t Rows() const noexcept {
+        return rows_;
+    }
+    size_t Cols() const noexcept {
+        return cols_;
+    }
+    size_t Stride() const noexcept {
+        return stride_;
+    }
+    T* Data() const noexcept {
+        return data_;
+    }
+
+    // Строки лежат подряд без промежутков
+    bool IsContiguous() const noexcept {
+        return stride_ == cols_ || rows_ <= 1;
+    }
+
+    T& operator()(size_t row, size_t col) const noexcept {
+        assert(row < rows_ && col < cols_);
+        return data_[row * stride_ + col];
+    }
+
+    views::Span<T> Row(size_t row) const noexcept {
+        assert(row < rows_);
+        return views::Span<T>(data_ + row * stride_, cols_);
+    }
+
+    StridedSpan<T> Col(size_t col) const noexcept {
+        assert(col < cols_);
+        return StridedSpan<T>(data_ + col, rows_, stride_);
+    }
+
+    // Подматрица rows x cols с левым верхним углом в (row, col)
+    MatrixView Block(size_t row, size_t col, size_t rows, size_t cols) const noexcept {
+        assert(row + rows <= rows_ && col + cols <= cols_);
+        return MatrixView(data_ + row * stride_ + col, rows, cols, stride_);
+    }
+
+    // Те же элементы в виде матрицы rows x cols; возможно только без промежутков между строками
+    MatrixView Reshape(size_t rows, size_t cols) const noexcept {
+        assert(IsContiguous() && rows * cols == rows_ * cols_);
+        return MatrixView(data_, rows, cols, cols);
+    }
+
+private:
+    T* data_;
+    size_t rows_;
+    size_t cols_;
+    size_t stride_;
+};
+
+namespace detail {
+
+    // Сторона квадратного блока транспонирования: два блока float по 4 КБ помещаются в L1
+    inline constexpr size_t TRANSPOSE_BLOCK = 32;
+
+    template <typename S, typename T>
+    void TransposeBlock(MatrixView<S> src, MatrixView<T> dst, size_t row, size_t col, size_t rows, size_t cols) {
+        size_t i = row;
+#if defined(__SSE__)
+        if constexpr (std::is_same_v<std::remove_const_t<S>, float>) {
+            // Ядро 4 x 4 на регистрах SSE: четыре строки читаются и записываются целиком
+            for (; i + 4 <= row + rows; i += 4) {
+                size_t j = col;
+                for (; j + 4 <= col + cols; j += 4) {
+                    __m128 r0 = _mm_loadu_ps(&src(i, j));
+                    __m128 r1 = _mm_loadu_ps(&src(i + 1, j));
+                    __m128 r2 = _mm_loadu_ps(&src(i + 2, j));
+                    __m128 r3 = _mm_loadu_ps(&src(i + 3, j));
+                    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+                    _mm_storeu_ps(&dst(j, i), r0);
+                    _mm_storeu_ps(&dst(j + 1, i), r1);
+                    _mm_storeu_ps(&dst(j + 2, i), r2);
+                    _mm_storeu_ps(&dst(j + 3, i), r3);
+                }
+                for (; j < col + cols; ++j) {
+                    for (size_t k = i; k < i + 4; ++k) {
+                        dst(j, k) = src(k, j);
+                    }
+                }
+            }
+        }
+#endif
+        for (; i < row + rows; ++i) {
+            for (size_t j = col; j < col + cols; ++j) {
+                dst(j, i) = src(i, j);
+            }
+        }
+    }
+
+}  // namespace detail
+
+// Записывает в dst (cols x rows) транспонированную src (rows x cols). Матрица обходится блоками
+// TRANSPOSE_BLOCK x TRANSPOSE_BLOCK, чтобы и чтение, и запись шли по строкам, уже лежащим в кэше.
+// src и dst не должны пересекаться
+template <typename S, typename T>
+void Transpose(MatrixView<S> src, MatrixView<T> dst) {
+    static_assert(std::is_same_v<std::remove_const_t<S>, T>, "Transpose needs matrices of the same element type");
+    assert(src.Rows() == dst.Cols() && src.Cols() == dst.Rows());
+    constexpr size_t BLOCK = detail::TRANSPOSE_BLOCK;
+    for (size_t row = 0; row < src.Rows(); row += BLOCK) {
+        const size_t rows = std::min(BLOCK, src.Rows() - row);
+        for (size_t col = 0; col < src.Cols(); col += BLOCK) {
+            detail::TransposeBlock(src, dst, row, col, rows, std::min(BLOCK, src.Cols() - col));
+        }
+    }
+}
+
+// Транспонирует матрицу rows x cols, хранящуюся в v, в новый вектор
+template <typename T>
+Vector<T> Transposed(const Vector<T>& v, size_t rows, size_t cols) {
+    Vector<T> result(v.Size());
+    Transpose(MatrixView<const T>(v, rows, cols), MatrixView<T>(result, cols, rows));
+    return result;
+}
\ No newline at end of file
@@ -0,0 +1,376 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Поэлементная арифметика над Vector<арифметический тип> на шаблонах выражений.
+// Выражение вроде a * x + b ничего не вычисляет и не выделяет память, а лишь запоминает операнды;
+// все операции выполняются одним циклом при присваивании вектору:
+//     using namespace numeric;
+//     c = a * x + b;
+// Операторы для самих векторов находятся только через using namespace numeric или numeric::View(a),
+// поэтому код, не подключивший этот слой, не меняет поведения. Сравнения записываются функциями
+// Less, Equal и т.д., их результат — выражение из bool, пригодное для Select и Count
+namespace numeric {
+
+// Ссылка на элементы вектора
+template <typename T>
+class Ref {
+public:
+    using value_type = T;
+    static constexpr bool IS_SCALAR = false;
+
+    explicit Ref(const Vector<T>& v) noexcept
+        : data_(v.begin())
+        , size_(v.Size()) {
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    T operator[](size_t index) const noexcept {
+        return data_[index];
+    }
+
+private:
+    const T* data_;
+    size_t size_;
+};
+
+// Число, одинаковое для всех позиций
+template <typename T>
+class Scalar {
+public:
+    using value_type = T;
+    static constexpr bool IS_SCALAR = true;
+
+    explicit Scalar(T value) noexcept
+        : value_(value) {
+    }
+
+    T operator[](size_t /*index*/) const noexcept {
+        return value_;
+    }
+
+private:
+    T value_;
+};
+
+// Результат Op над элементами операндов в одной и той же позиции. Операнды хранятся по значению:
+// это либо Ref, либо Scalar, либо другие выражения, поэтому копирование дёшево
+template <typename Op, typename... Args>
+class Expression {
+public:
+    using value_type = std::invoke_result_t<Op, typename Args::value_type...>;
+    static constexpr bool IS_SCALAR = false;
+
+    explicit Expression(Args... args)
+        : args_(std::move(args)...) {
+        size_ = std::apply([](const auto&... arg) { return CommonSize(arg...); }, args_);
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    value_type operator[](size_t index) const {
+        return std::apply([index](const auto&... arg) { return Op()(arg[index]...); }, args_);
+    }
+
+private:
+    template <typename... Nodes>
+    static size_t CommonSize(const Nodes&... nodes) noexcept {
+        size_t size = 0;
+        bool found = false;
+        const auto visit = [&size, &found](const auto& node) {
+            if constexpr (!std::decay_t<decltype(node)>::IS_SCALAR) {
+                // Операнды одного выражения должны иметь одинаковый размер
+                assert(!found || size == node.Size());
+                size = node.Size();
+                found = true;
+            }
+        };
+        (visit(nodes), ...);
+        return size;
+    }
+
+    std::tuple<Args...> args_;
+    size_t size_ = 0;
+};
+
+namespace detail {
+
+    template <typename T>
+    struct IsExpression : std::false_type {};
+    template <typename Op, typename... Args>
+    struct IsExpression<Expression<Op, Args...>> : std::true_type {};
+    template <typename T>
+    struct IsExpression<Ref<T>> : std::true_type {};
+
+    template <typename T>
+    struct IsNumericVector : std::false_type {};
+    template <typename T>
+    struct IsNumericVector<Vector<T>> : std::is_arithmetic<T> {};
+
+    template <typename X>
+    inline constexpr bool IS_NODE = IsExpression<X>::value || IsNumericVector<X>::value;
+
+    template <typename X>
+    inline constexpr bool IS_OPERAND = IS_NODE<X> || std::is_arithmetic_v<X>;
+
+    template <typename X>
+    struct ValueOf {
+        using type = typename X::value_type;
+    };
+    template <typename T>
+    struct ValueOf<Vector<T>> {
+        using type = T;
+    };
+
+    // Общий тип элементов операндов-векторов и выражений; void, если все операнды — числа
+    template <typename... Xs>
+    struct ElementOf {
+        using type = void;
+    };
+    template <typename Element, typename Rest>
+    struct Common {
+        using type = std::common_type_t<Element, Rest>;
+    };
+    template <typename Element>
+    struct Common<Element, void> {
+        using type = Element;
+    };
+
+    template <typename X, typename Rest, bool IsNode = IS_NODE<X>>
+    struct Combine {
+        using type = typename Common<typename ValueOf<X>::type, Rest>::type;
+    };
+    template <typename X, typename Rest>
+    struct Combine<X, Rest, false> {
+        using type = Rest;
+    };
+
+    template <typename X, typename... Xs>
+    struct ElementOf<X, Xs...> {
+        using type = typename Combine<X, typename ElementOf<Xs...>::type>::type;
+    };
+
+    // Тип, в котором вычисляется выражение. Числа приводятся к типу элементов, так что v * 2.0
+    // для Vector<float> остаётся вычислением во float. Для целых элементов берётся общий тип с числами,
+    // иначе v * 2.5 для Vector<int> молча умножало бы на 2, а Equal(v, 0.5) сравнивало бы с 0
+    template <typename Element, typename X, bool Widen = std::is_integral_v<Element> && std::is_arithmetic_v<X>>
+    struct WidenBy {
+        using type = Element;
+    };
+    template <typename Element, typename X>
+    struct WidenBy<Element, X, true> {
+        using type = std::common_type_t<Element, X>;
+    };
+
+    template <typename Element, typename... Xs>
+    struct WidenByAll {
+        using type = Element;
+    };
+    template <typename Element, typename X, typename... Xs>
+    struct WidenByAll<Element, X, Xs...> {
+        using type = typename WidenByAll<typename WidenBy<Element, X>::type, Xs...>::type;
+    };
+
+    template <typename... Xs>
+    using ElementOfT = typename WidenByAll<typename ElementOf<Xs...>::type, Xs...>::type;
+
+    // Выражение из bool, например результат сравнения
+    template <typename X, typename = void>
+    inline constexpr bool IS_CONDITION = false;
+    template <typename X>
+    inline constexpr bool IS_CONDITION<X, std::enable_if_t<IS_NODE<X>>> = std::is_same_v<typename ValueOf<X>::type, bool>;
+
+    template <typename E, typename X>
+    auto Lift(const X& x) {
+        if constexpr (IsNumericVector<X>::value) {
+            return Ref<typename ValueOf<X>::type>(x);
+        }
+        else if constexpr (IsExpression<X>::value) {
+            return x;
+        }
+        else {
+            return Scalar<E>(static_cast<E>(x));
+        }
+    }
+
+    template <typename Op, typename E, typename... Xs>
+    auto Make(const Xs&... xs) {
+        return Expression<Op, decltype(Lift<E>(xs))...>(Lift<E>(xs)...);
+    }
+
+    template <typename... Xs>
+    inline constexpr bool IS_EXPRESSION_ARGS = (IS_OPERAND<Xs> && ...) && !std::is_void_v<ElementOfT<Xs...>>;
+
+    struct Negate {
+        template <typename T>
+        auto operator()(T value) const noexcept {
+            return -value;
+        }
+    };
+
+    struct MultiplyAdd {
+        template <typename T>
+        T operator()(T a, T b, T c) const noexcept {
+#ifdef __FMA__
+            if constexpr (std::is_floating_point_v<T>) {
+                return std::fma(a, b, c);
+            }
+#endif
+            // Без аппаратного FMA std::fma вызывает медленную программную реализацию
+            return a * b + c;
+        }
+    };
+
+    struct Choose {
+        template <typename T>
+        T operator()(bool condition, T if_true, T if_false) const noexcept {
+            return condition ? if_true : if_false;
+        }
+    };
+
+}  // namespace detail
+
+template <typename T>
+Ref<T> View(const Vector<T>& v) noexcept {
+    static_assert(std::is_arithmetic_v<T>, "numeric works with vectors of arithmetic types only");
+    return Ref<T>(v);
+}
+
+#define NUMERIC_BINARY_OPERATOR(op, Op)                                                         \
+    template <typename L, typename R, std::enable_if_t<detail::IS_EXPRESSION_ARGS<L, R>, int> = 0> \
+    auto operator op(const L& lhs, const R& rhs) {                                              \
+        return detail::Make<Op, detail::ElementOfT<L, R>>(lhs, rhs);                            \
+    }
+
+NUMERIC_BINARY_OPERATOR(+, std::plus<>)
+NUMERIC_BINARY_OPERATOR(-, std::minus<>)
+NUMERIC_BINARY_OPERATOR(*, std::multiplies<>)
+NUMERIC_BINARY_OPERATOR(/, std::divides<>)
+
+#undef NUMERIC_BINARY_OPERATOR
+
+template <typename X, std::enable_if_t<detail::IS_EXPRESSION_ARGS<X>, int> = 0>
+auto operator-(const X& x) {
+    return detail::Make<detail::Negate, detail::ElementOfT<X>>(x);
+}
+
+#define NUMERIC_COMPARISON(Name, Op)                                                            \
+    template <typename L, typename R, std::enable_if_t<detail::IS_EXPRESSION_ARGS<L, R>, int> = 0> \
+    auto Name(const L& lhs, const R& rhs) {                                                     \
+        return detail::Make<Op, detail::ElementOfT<L, R>>(lhs, rhs);                            \
+    }
+
+NUMERIC_COMPARISON(Equal, std::equal_to<>)
+NUMERIC_COMPARISON(NotEqual, std::not_equal_to<>)
+NUMERIC_COMPARISON(Less, std::less<>)
+NUMERIC_COMPARISON(LessEqual, std::less_equal<>)
+NUMERIC_COMPARISON(Greater, std::greater<>)
+NUMERIC_COMPARISON(GreaterEqual, std::greater_equal<>)
+
+#undef NUMERIC_COMPARISON
+
+// a * b + c с одним округлением, если процессор поддерживает FMA
+template <typename A, typename B, typename C, std::enable_if_t<detail::IS_EXPRESSION_ARGS<A, B, C>, int> = 0>
+auto Fma(const A& a, const B& b, const C& c) {
+    return detail::Make<detail::MultiplyAdd, detail::ElementOfT<A, B, C>>(a, b, c);
+}
+
+// Поэлементно condition ? if_true : if_false; ветвление заменяется выбором, и цикл векторизуется
+template <typename Cond, typename A, typename B,
+          std::enable_if_t<detail::IS_EXPRESSION_ARGS<Cond> && detail::IS_OPERAND<A> && detail::IS_OPERAND<B>, int> = 0>
+auto Select(const Cond& condition, const A& if_true, const B& if_false) {
+    using Element = typename std::conditional_t<std::is_void_v<detail::ElementOfT<A, B>>, std::common_type<A, B>,
+                                                std::type_identity<detail::ElementOfT<A, B>>>::type;
+    return detail::Make<detail::Choose, Element>(condition, if_true, if_false);
+}
+
+// Редукции складывают в нескольких независимых аккумуляторах, чтобы сложения не ждали друг друга
+// и цикл векторизовался без -ffast-math. Поэтому порядок сложения чисел с плавающей точкой
+// отличается от последовательного
+namespace detail {
+
+    inline constexpr size_t LANES = 8;
+
+    template <typename Node, typename T, typename Combine>
+    T Reduce(const Node& node, T init, Combine combine) {
+        const size_t size = node.Size();
+        T acc[LANES];
+        std::fill(std::begin(acc), std::end(acc), init);
+        size_t i = 0;
+        for (; i + LANES <= size; i += LANES) {
+            for (size_t lane = 0; lane < LANES; ++lane) {
+                acc[lane] = combine(acc[lane], static_cast<T>(node[i + lane]));
+            }
+        }
+        for (; i < size; ++i) {
+            acc[0] = combine(acc[0], static_cast<T>(node[i]));
+        }
+        T result = acc[0];
+        for (size_t lane = 1; lane < LANES; ++lane) {
+            result = combine(result, acc[lane]);
+        }
+        return result;
+    }
+
+}  // namespace detail
+
+template <typename X, std::enable_if_t<detail::IS_EXPRESSION_ARGS<X>, int> = 0>
+auto Sum(const X& x) {
+    using T = detail::ElementOfT<X>;
+    return detail::Reduce(detail::Lift<T>(x), T(), std::plus<>());
+}
+
+template <typename L, typename R, std::enable_if_t<detail::IS_EXPRESSION_ARGS<L, R>, int> = 0>
+auto Dot(const L& lhs, const R& rhs) {
+    return Sum(lhs * rhs);
+}
+
+// Наименьший элемент непустого выражения
+template <typename X, std::enable_if_t<detail::IS_EXPRESSION_ARGS<X>, int> = 0>
+auto Min(const X& x) {
+    using T = detail::ElementOfT<X>;
+    const auto node = detail::Lift<T>(x);
+    assert(node.Size() > 0);
+    return detail::Reduce(node, static_cast<T>(node[0]), [](T lhs, T rhs) {
+        return std::min(lhs, rhs);
+    });
+}
+
+// Наибольший элемент непустого выражения
+template <typename X, std::enable_if_t<detail::IS_EXPRESSION_ARGS<X>, int> = 0>
+auto Max(const X& x) {
+    using T = detail::ElementOfT<X>;
+    const auto node = detail::Lift<T>(x);
+    assert(node.Size() > 0);
+    return detail::Reduce(node, static_cast<T>(node[0]), [](T lhs, T rhs) {
+        return std::max(lhs, rhs);
+    });
+}
+
+// Количество истинных элементов условия, например Less(a, b). Выражения не из bool не принимаются:
+// их сумма, приведённая к size_t, не была бы количеством
+template <typename X, std::enable_if_t<detail::IS_CONDITION<X>, int> = 0>
+size_t Count(const X& x) {
+    const auto node = detail::Lift<detail::ElementOfT<X>>(x);
+    return detail::Reduce(node, size_t(0), [](size_t lhs, size_t rhs) {
+        return lhs + rhs;
+    });
+}
+
+}  // namespace numeric
+
+template <typename Op, typename... Args>
+struct IsVectorExpression<numeric::Expression<Op, Args...>> : std::true_type {};
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Число потоков по умолчанию для параллельных алгоритмов
+inline size_t DefaultThreadCount() noexcept {
+    // hardware_concurrency читает сведения о системе при каждом вызове, поэтому результат запоминается
+    static const size_t count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    return count;
+}
+
+// Постоянный набор рабочих потоков для параллельных алгоритмов: создание потока стоит десятки
+// микросекунд, и создавать их заново на каждый вызов слишком дорого для участков в сотни микросекунд
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t workers) {
+        workers_.Reserve(workers);
+        for (size_t i = 0; i < workers; ++i) {
+            try {
+                workers_.EmplaceBack([this] {
+                    Work();
+                });
+            }
+            catch (const std::system_error&) {
+                // Система не даёт больше потоков: пул работает с теми, что удалось создать
+                break;
+            }
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard guard(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    // Число рабочих потоков, не считая вызывающего Run
+    size_t Size() const noexcept {
+        return workers_.Size();
+    }
+
+    // Вызывает task(index) для каждого index из [0, count) на рабочих потоках и в вызывающем потоке
+    // и возвращается, когда все вызовы завершены. Первое исключение из task бросается после этого,
+    // а ещё не начатые вызовы отменяются. Вызовы Run из разных потоков выполняются по очереди,
+    // а вызов изнутри task выполняется целиком в текущем потоке
+    template <typename Task>
+    void Run(size_t count, Task&& task) {
+        Batch batch;
+        batch.count = count;
+        batch.context = std::addressof(task);
+        batch.call = [](void* context, size_t index) {
+            (*static_cast<std::remove_reference_t<Task>*>(context))(index);
+        };
+        if (count <= 1 || workers_.Size() == 0 || current_pool_ == this) {
+            Drain(batch);
+        }
+        else {
+            std::lock_guard run_guard(run_mutex_);
+            {
+                std::lock_guard guard(mutex_);
+                batch_ = &batch;
+                ++generation_;
+            }
+            wake_.notify_all();
+            // Вложенный Run из task в этом потоке выполнится на месте, а не будет ждать run_mutex_
+            ThreadPool* const outer_pool = std::exchange(current_pool_, this);
+            Drain(batch);
+            current_pool_ = outer_pool;
+            // Все вызовы уже разобраны; осталось дождаться потоков, которые их выполняют
+            std::unique_lock lock(mutex_);
+            batch_ = nullptr;
+            done_.wait(lock, [&batch] {
+                return batch.active == 0;
+            });
+        }
+        if (batch.error) {
+            std::rethrow_exception(batch.error);
+        }
+    }
+
+private:
+    struct Batch {
+        size_t count = 0;
+        void* context = nullptr;
+        void (*call)(void*, size_t) = nullptr;
+        std::atomic<size_t> next = 0;
+        // Рабочие потоки, взявшие эту партию; изменяется под mutex_
+        size_t active = 0;
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    static void Drain(Batch& batch) noexcept {
+        for (size_t index; (index = batch.next.fetch_add(1)) < batch.count;) {
+            try {
+                batch.call(batch.context, index);
+            }
+            catch (...) {
+                std::lock_guard guard(batch.error_mutex);
+                if (!batch.error) {
+                    batch.error = std::current_exception();
+                }
+                batch.next = batch.count;
+            }
+        }
+    }
+
+    void Work() {
+        current_pool_ = this;
+        uint64_t seen = 0;
+        std::unique_lock lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this, seen] {
+                return stop_ || (batch_ != nullptr && generation_ != seen);
+            });
+            if (stop_) {
+                return;
+            }
+            seen = generation_;
+            Batch& batch = *batch_;
+            ++batch.active;
+            lock.unlock();
+            Drain(batch);
+            lock.lock();
+            if (--batch.active == 0) {
+                done_.notify_all();
+            }
+        }
+    }
+
+    // Пул, задачу которого выполняет текущий поток
+    static inline thread_local ThreadPool* current_pool_ = nullptr;
+
+    std::mutex run_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    Batch* batch_ = nullptr;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+    Vector<std::thread> workers_;
+};
+
+// Общий пул, которым пользуются параллельные алгоритмы: по рабочему потоку на каждое ядро,
+// кроме одного, занятого вызывающим потоком
+inline ThreadPool& DefaultThreadPool() {
+    static ThreadPool pool(DefaultThreadCount() - 1);
+    return pool;
+}
+
+// Делит [begin, end) на threads участков подряд и вызывает body(from, to) для каждого на потоках
+// DefaultThreadPool; один из участков обрабатывает вызывающий поток. Участки короче min_chunk
+// не выделяются, так что маленькие диапазоны обрабатываются без передачи другим потокам.
+// Первое исключение из body бросается после завершения всех начатых участков
+template <typename Body>
+void ParallelFor(size_t begin, size_t end, Body body, size_t threads = 0, size_t min_chunk = 4096) {
+    if (begin >= end) {
+        return;
+    }
+    if (threads == 0) {
+        threads = DefaultThreadCount();
+    }
+    const size_t size = end - begin;
+    threads = std::clamp<size_t>(size / std::max<size_t>(min_chunk, 1), 1, threads);
+    if (threads == 1) {
+        body(begin, end);
+        return;
+    }
+    DefaultThreadPool().Run(threads, [&](size_t chunk) {
+        body(begin + size * chunk / threads, begin + size * (chunk + 1) / threads);
+    });
+}
\ No newline at end of file
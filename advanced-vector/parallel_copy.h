@@ -0,0 +1,134 @@
+#pragma once
+#include "parallel.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// Копирование больших векторов тривиально копируемых элементов с упором в пропускную способность памяти.
+// Один поток упирается в число одновременных промахов одного ядра и получает лишь часть пропускной
+// способности памяти, поэтому копия делится между потоками DefaultThreadPool. Когда копия заведомо
+// не помещается в кэш, запись идёт в обход кэша (non-temporal): строки приёмника не читаются
+// перед записью и не вытесняют из кэша остальные данные.
+// Перемещение Vector и так стоит O(1) — переставляется буфер, поэтому отдельной версии для него нет
+
+// Копии короче этого размера выполняются в вызывающем потоке: передача участков другим потокам
+// окупается, только когда копия заметно дольше пробуждения потока
+inline constexpr size_t PARALLEL_COPY_BYTES = 1024 * 1024;
+
+// Копии от этого размера пишутся в обход кэша: приёмник уже не помещается в L2 и в долю L3 одного ядра,
+// и запись без чтения строк выигрывает 20–30%. Меньшие копии остаются в кэше, и следующий
+// за копированием код прочитает их оттуда, а не из памяти
+inline constexpr size_t NON_TEMPORAL_COPY_BYTES = 8 * 1024 * 1024;
+
+namespace detail {
+
+    inline constexpr size_t CACHE_LINE_BYTES = 64;
+
+    // memcpy с записью в обход кэша. Приёмник выравнивается по ширине регистра, хвосты копируются memcpy.
+    // Потоковые записи не упорядочены с обычными, поэтому в конце стоит sfence
+    inline void StreamCopy(const unsigned char* from, size_t bytes, unsigned char* to) noexcept {
+#if defined(__AVX__)
+        using Register = __m256i;
+#elif defined(__SSE2__)
+        using Register = __m128i;
+#endif
+#if defined(__SSE2__)
+        constexpr size_t WIDTH = sizeof(Register);
+        const size_t head = std::min((WIDTH - reinterpret_cast<uintptr_t>(to) % WIDTH) % WIDTH, bytes);
+        std::memcpy(to, from, head);
+        size_t i = head;
+        for (; i + WIDTH <= bytes; i += WIDTH) {
+#if defined(__AVX__)
+            _mm256_stream_si256(reinterpret_cast<Register*>(to + i),
+                                _mm256_loadu_si256(reinterpret_cast<const Register*>(from + i)));
+#else
+            _mm_stream_si128(reinterpret_cast<Register*>(to + i),
+                             _mm_loadu_si128(reinterpret_cast<const Register*>(from + i)));
+#endif
+        }
+        std::memcpy(to + i, from + i, bytes - i);
+        _mm_sfence();
+#else
+        std::memcpy(to, from, bytes);
+#endif
+    }
+
+    inline void CopyBytes(const unsigned char* from, size_t bytes, unsigned char* to, bool non_temporal) noexcept {
+        if (non_temporal) {
+            StreamCopy(from, bytes, to);
+        }
+        else {
+            std::memcpy(to, from, bytes);
+        }
+    }
+
+}  // namespace detail
+
+// Копирует count элементов из from в неперекрывающийся с ним to на threads потоках (0 — по числу ядер).
+// Участки потоков начинаются на границах строк кэша приёмника, чтобы потоки не писали в одну строку
+template <typename T>
+void ParallelCopy(const T* from, size_t count, T* to, size_t threads = 0) {
+    static_assert(std::is_trivially_copyable_v<T>, "ParallelCopy requires a trivially copyable element type");
+    const auto* source = reinterpret_cast<const unsigned char*>(from);
+    auto* target = reinterpret_cast<unsigned char*>(to);
+    const size_t bytes = count * sizeof(T);
+    const bool non_temporal = bytes >= NON_TEMPORAL_COPY_BYTES;
+    if (bytes == 0) {
+        return;
+    }
+    if (bytes < PARALLEL_COPY_BYTES) {
+        std::memcpy(target, source, bytes);
+        return;
+    }
+    using detail::CACHE_LINE_BYTES;
+    const size_t head = (CACHE_LINE_BYTES - reinterpret_cast<uintptr_t>(target) % CACHE_LINE_BYTES) % CACHE_LINE_BYTES;
+    const size_t lines = (bytes - head) / CACHE_LINE_BYTES;
+    ParallelFor(
+        0, lines,
+        [&](size_t first, size_t last) {
+            const size_t begin = first == 0 ? 0 : head + first * CACHE_LINE_BYTES;
+            const size_t end = last == lines ? bytes : head + last * CACHE_LINE_BYTES;
+            detail::CopyBytes(source + begin, end - begin, target + begin, non_temporal);
+        },
+        threads, PARALLEL_COPY_BYTES / CACHE_LINE_BYTES);
+}
+
+// to = from, при этом элементы копируются ParallelCopy. Для не тривиально копируемых T — обычное присваивание
+template <typename T>
+void ParallelAssign(Vector<T>& to, const Vector<T>& from, size_t threads = 0) {
+    if (&to == &from) {
+        return;
+    }
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        // Старые элементы не нужны, и переносить их в новый буфер незачем
+        to.Clear();
+        ParallelCopy(from.begin(), from.Size(), to.ExtendUninitialized(from.Size()), threads);
+    }
+    else {
+        to = from;
+    }
+}
+
+// Добавляет элементы from в конец to, копируя их ParallelCopy. from может совпадать с to
+template <typename T>
+void ParallelAppend(Vector<T>& to, const Vector<T>& from, size_t threads = 0) {
+    const size_t count = from.Size();
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        T* out = to.ExtendUninitialized(count);
+        // Расширение могло переместить буфер to, поэтому начало from берётся после него
+        ParallelCopy(from.begin(), count, out, threads);
+    }
+    else {
+        to.Reserve(std::max(to.Size() + count, to.Size() * 2));
+        for (size_t i = 0; i < count; ++i) {
+            to.PushBack(from[i]);
+        }
+    }
+}
\ No newline at end of file
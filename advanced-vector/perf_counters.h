@@ -0,0 +1,185 @@
+#pragma once
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <utility>
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+// Аппаратные счётчики производительности текущего потока и потоков, которые он запустит после создания
+// счётчиков, через perf_event (только Linux).
+// Если ядро или окружение не даёт их открыть, IsAvailable() возвращает false, а Start/Stop ничего не делают
+class PerfCounters {
+public:
+    enum Event {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        DTLB_MISSES,
+        EVENT_COUNT
+    };
+
+    static constexpr std::array<std::string_view, EVENT_COUNT> NAMES = {
+        "cycles", "instructions", "L1d-misses", "LLC-misses", "branch-misses", "dTLB-misses"};
+
+    // Значения, отмасштабированные с учётом мультиплексирования; -1 — счётчик недоступен
+    using Values = std::array<double, EVENT_COUNT>;
+
+    PerfCounters() {
+#if defined(__linux__)
+        const std::array<std::pair<uint32_t, uint64_t>, EVENT_COUNT> configs = {{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, CacheConfig(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {PERF_TYPE_HW_CACHE, CacheConfig(PERF_COUNT_HW_CACHE_DTLB)},
+        }};
+        // Счётчики открываются по отдельности, чтобы отсутствие одного (например, dTLB в виртуальной машине)
+        // не отключало остальные
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            fds_[i] = Open(configs[i].first, configs[i].second);
+            if (fds_[i] >= 0) {
+                available_ = true;
+            }
+            else if (error_.empty()) {
+                error_ = std::string(NAMES[i]) + ": " + std::strerror(errno);
+            }
+        }
+#else
+        error_ = "perf_event is supported only on Linux";
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    bool IsAvailable() const noexcept {
+        return available_;
+    }
+
+    // Причина, по которой не открылся первый из недоступных счётчиков
+    const std::string& Error() const noexcept {
+        return error_;
+    }
+
+    // Обнуляет значения. Время работы счётчиков ядро не обнуляет, поэтому оно запоминается
+    // и Read масштабирует по времени, прошедшему с Reset
+    void Reset() noexcept {
+        Control(PERF_IOC_RESET);
+#if defined(__linux__)
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            ReadRaw(i, reset_times_[i]);
+        }
+#endif
+    }
+
+    void Start() noexcept {
+        Control(PERF_IOC_ENABLE);
+    }
+
+    void Stop() noexcept {
+        Control(PERF_IOC_DISABLE);
+    }
+
+    Values Read() const noexcept {
+        Values values;
+        values.fill(-1);
+#if defined(__linux__)
+        for (size_t i = 0; i < EVENT_COUNT; ++i) {
+            RawValue data;
+            if (!ReadRaw(i, data)) {
+                continue;
+            }
+            const uint64_t enabled = data.time_enabled - reset_times_[i].time_enabled;
+            const uint64_t running = data.time_running - reset_times_[i].time_running;
+            // Счётчик, который с Reset ни разу не попал на процессор, ничего не измерил и остаётся недоступным
+            if (running == 0) {
+                continue;
+            }
+            values[i] = static_cast<double>(data.value) * static_cast<double>(enabled) / static_cast<double>(running);
+        }
+#endif
+        return values;
+    }
+
+private:
+#if defined(__linux__)
+    static constexpr unsigned long PERF_IOC_RESET = PERF_EVENT_IOC_RESET;
+    static constexpr unsigned long PERF_IOC_ENABLE = PERF_EVENT_IOC_ENABLE;
+    static constexpr unsigned long PERF_IOC_DISABLE = PERF_EVENT_IOC_DISABLE;
+
+    // Формат read с PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING
+    struct RawValue {
+        uint64_t value = 0;
+        uint64_t time_enabled = 0;
+        uint64_t time_running = 0;
+    };
+
+    bool ReadRaw(size_t i, RawValue& data) const noexcept {
+        return fds_[i] >= 0 && read(fds_[i], &data, sizeof(data)) == static_cast<ssize_t>(sizeof(data));
+    }
+
+    static constexpr uint64_t CacheConfig(uint64_t cache) noexcept {
+        return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    static int Open(uint32_t type, uint64_t config) noexcept {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        // Учитываются и потоки, запущенные после открытия счётчика: пул ParallelFor и стадии конвейера
+        attr.inherit = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    void Control(unsigned long request) noexcept {
+        for (int fd : fds_) {
+            if (fd >= 0) {
+                ioctl(fd, request, 0);
+            }
+        }
+    }
+
+    std::array<int, EVENT_COUNT> fds_{};
+    std::array<RawValue, EVENT_COUNT> reset_times_{};
+#else
+    static constexpr unsigned long PERF_IOC_RESET = 0;
+    static constexpr unsigned long PERF_IOC_ENABLE = 0;
+    static constexpr unsigned long PERF_IOC_DISABLE = 0;
+
+    void Control(unsigned long /*request*/) noexcept {
+    }
+#endif
+    bool available_ = false;
+    std::string error_;
+};
+
+}  // namespace bench
\ No newline at end of file
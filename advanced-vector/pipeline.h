@@ -0,0 +1,268 @@
+#pragma once
+#include "vector.h"
+#include "views.h"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// Очередь фиксированной ёмкости для передачи данных между потоками. Push ждёт свободного места,
+// Pop — элемента; после Close() Push ничего не добавляет, а Pop возвращает false, когда очередь опустеет
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : items_(capacity) {
+        assert(capacity > 0);
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // Возвращает false, если очередь закрыта
+    bool Push(T item) {
+        std::unique_lock lock(mutex_);
+        not_full_.wait(lock, [this] {
+            return closed_ || size_ < items_.Size();
+        });
+        if (closed_) {
+            return false;
+        }
+        items_[(head_ + size_) % items_.Size()] = std::move(item);
+        ++size_;
+        not_empty_.notify_one();
+        return true;
+    }
+
+    bool Pop(T& item) {
+        std::unique_lock lock(mutex_);
+        not_empty_.wait(lock, [this] {
+            return closed_ || size_ > 0;
+        });
+        if (size_ == 0) {
+            return false;
+        }
+        item = std::move(items_[head_]);
+        head_ = (head_ + 1) % items_.Size();
+        --size_;
+        not_full_.notify_one();
+        return true;
+    }
+
+    void Close() {
+        std::lock_guard guard(mutex_);
+        closed_ = true;
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+    Vector<T> items_;
+    size_t head_ = 0;
+    size_t size_ = 0;
+    bool closed_ = false;
+};
+
+// Многостадийная обработка вектора по частям. Вектор делится на участки примерно по chunk_bytes,
+// и все стадии проходят один участок, пока он лежит в кэше L2, вместо того чтобы каждая стадия
+// заново читала весь массив из памяти.
+// Стадия получает участок и может переупорядочить или отбросить элементы: она возвращает, сколько
+// элементов в начале участка осталось. Оставшиеся элементы всех участков в исходном порядке
+// образуют результат. Стадия обрабатывает участки строго по порядку и всегда в одном потоке,
+// поэтому накапливать в ней состояние (например, сумму) можно без синхронизации
+template <typename T>
+class Pipeline {
+public:
+    using Stage = std::function<size_t(views::Span<T>)>;
+
+    // Половина типичного L2, чтобы рядом с участком поместились данные самих стадий
+    static constexpr size_t DEFAULT_CHUNK_BYTES = 256 * 1024;
+
+    explicit Pipeline(size_t chunk_bytes = DEFAULT_CHUNK_BYTES)
+        : chunk_size_(std::max<size_t>(chunk_bytes / sizeof(T), 1)) {
+    }
+
+    Pipeline& AddStage(Stage stage) {
+        stages_.PushBack(std::move(stage));
+        return *this;
+    }
+
+    // Стадия, применяющая func к каждому элементу
+    template <typename Func>
+    Pipeline& AddTransform(Func func) {
+        return AddStage([func = std::move(func)](views::Span<T> chunk) {
+            for (T& item : chunk) {
+                func(item);
+            }
+            return chunk.Size();
+        });
+    }
+
+    // Стадия, оставляющая элементы, для которых pred истинен
+    template <typename Pred>
+    Pipeline& AddFilter(Pred pred) {
+        return AddStage([pred = std::move(pred)](views::Span<T> chunk) {
+            return static_cast<size_t>(std::remove_if(chunk.begin(), chunk.end(), [&pred](const T& item) {
+                                           return !pred(item);
+                                       })
+                                       - chunk.begin());
+        });
+    }
+
+    size_t ChunkSize() const noexcept {
+        return chunk_size_;
+    }
+
+    // Выполняет все стадии над каждым участком в текущем потоке
+    void Run(Vector<T>& data) const {
+        Compactor compactor(data);
+        for (size_t begin = 0; begin < data.Size(); begin += chunk_size_) {
+            Chunk chunk{begin, std::min(chunk_size_, data.Size() - begin)};
+            for (const Stage& stage : stages_) {
+                Apply(stage, data, chunk);
+            }
+            compactor.Append(chunk);
+        }
+        compactor.Finish();
+    }
+
+    // Выполняет каждую стадию в своём потоке; участки передаются между стадиями через очереди
+    // на queue_capacity участков. Стадии работают одновременно над разными участками,
+    // а ограниченные очереди не дают быстрой стадии уйти далеко вперёд и вытеснить участки из кэша.
+    // Исключение из любой стадии останавливает конвейер и бросается из RunThreaded, а содержимое data
+    // после этого не определено
+    void RunThreaded(Vector<T>& data, size_t queue_capacity = 4) const {
+        if (stages_.Size() < 2) {
+            Run(data);
+            return;
+        }
+        // queues[i] ведёт к стадии i + 1, последняя очередь — к уплотнению результата
+        Vector<std::unique_ptr<BoundedQueue<Chunk>>> queues;
+        queues.Reserve(stages_.Size());
+        for (size_t i = 0; i < stages_.Size(); ++i) {
+            queues.PushBack(std::make_unique<BoundedQueue<Chunk>>(queue_capacity));
+        }
+
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        const auto fail = [&](std::exception_ptr e) {
+            {
+                std::lock_guard guard(error_mutex);
+                if (!error) {
+                    error = e;
+                }
+            }
+            for (const auto& queue : queues) {
+                queue->Close();
+            }
+        };
+
+        Vector<std::thread> threads;
+        threads.Reserve(stages_.Size());
+        try {
+            for (size_t i = 0; i < stages_.Size(); ++i) {
+                threads.PushBack(std::thread([&, i] {
+                    try {
+                        Chunk chunk;
+                        if (i == 0) {
+                            for (size_t begin = 0; begin < data.Size(); begin += chunk_size_) {
+                                chunk = {begin, std::min(chunk_size_, data.Size() - begin)};
+                                Apply(stages_[0], data, chunk);
+                                if (!queues[0]->Push(chunk)) {
+                                    break;
+                                }
+                            }
+                        }
+                        else {
+                            while (queues[i - 1]->Pop(chunk)) {
+                                Apply(stages_[i], data, chunk);
+                                if (!queues[i]->Push(chunk)) {
+                                    break;
+                                }
+                            }
+                        }
+                        queues[i]->Close();
+                    }
+                    catch (...) {
+                        fail(std::current_exception());
+                    }
+                }));
+            }
+        }
+        catch (...) {
+            // Поток не создался: уже запущенные стадии останавливаются закрытием очередей и присоединяются,
+            // иначе деструктор threads с присоединяемыми потоками вызвал бы std::terminate
+            for (const auto& queue : queues) {
+                queue->Close();
+            }
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            throw;
+        }
+
+        Compactor compactor(data);
+        Chunk chunk;
+        while (queues[stages_.Size() - 1]->Pop(chunk)) {
+            compactor.Append(chunk);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        compactor.Finish();
+    }
+
+private:
+    // Участок data: size оставшихся элементов, начиная с begin
+    struct Chunk {
+        size_t begin = 0;
+        size_t size = 0;
+    };
+
+    static void Apply(const Stage& stage, Vector<T>& data, Chunk& chunk) {
+        const size_t kept = stage(views::Span<T>(data.begin() + chunk.begin, chunk.size));
+        assert(kept <= chunk.size);
+        chunk.size = kept;
+    }
+
+    // Сдвигает оставшиеся элементы участков, пришедших по порядку, в начало вектора
+    class Compactor {
+    public:
+        explicit Compactor(Vector<T>& data) noexcept
+            : data_(data) {
+        }
+
+        void Append(const Chunk& chunk) {
+            if (chunk.begin != size_) {
+                std::move(data_.begin() + chunk.begin, data_.begin() + chunk.begin + chunk.size, data_.begin() + size_);
+            }
+            size_ += chunk.size;
+        }
+
+        void Finish() {
+            while (data_.Size() > size_) {
+                data_.PopBack();
+            }
+        }
+
+    private:
+        Vector<T>& data_;
+        size_t size_ = 0;
+    };
+
+    size_t chunk_size_;
+    Vector<Stage> stages_;
+};
\ No newline at end of file
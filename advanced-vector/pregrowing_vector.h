@@ -0,0 +1,178 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+// Вектор, который готовит следующий блок памяти заранее. Когда размер переходит долю threshold
+// от ёмкости, вспомогательный поток выделяет вдвое больший блок и касается каждой его страницы,
+// чтобы ядро отобразило их заранее. Вставка, заполнившая ёмкость, забирает готовый блок и тратит время
+// только на перенос элементов, а не на выделение памяти и сбои страниц при первой записи.
+// Блоки меньше PREGROW_MIN_BYTES выделяются как обычно: для них запуск потока дороже самого выделения
+template <typename T>
+class PregrowingVector {
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    static constexpr size_t PREGROW_MIN_BYTES = 1024 * 1024;
+    static constexpr double DEFAULT_THRESHOLD = 0.75;
+
+    explicit PregrowingVector(double threshold = DEFAULT_THRESHOLD) noexcept
+        : threshold_(threshold) {
+        assert(threshold > 0 && threshold <= 1);
+    }
+
+    PregrowingVector(const PregrowingVector&) = delete;
+    PregrowingVector& operator=(const PregrowingVector&) = delete;
+
+    // Деструктор ждёт вспомогательный поток, если тот ещё готовит блок
+    ~PregrowingVector() {
+        std::destroy_n(data_.GetAddress(), size_);
+    }
+
+    iterator begin() noexcept {
+        return data_.GetAddress();
+    }
+    iterator end() noexcept {
+        return data_ + size_;
+    }
+    const_iterator begin() const noexcept {
+        return data_.GetAddress();
+    }
+    const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    // Готовится ли или уже готов следующий блок
+    bool HasNextBlock() const noexcept {
+        return next_.valid();
+    }
+
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    T& EmplaceBack(Args&&... args) {
+        T* elem = nullptr;
+        if (size_ == Capacity()) {
+            RawMemory<T> new_data = TakeBlock(size_ == 0 ? 1 : size_ * 2);
+            elem = std::construct_at(new_data + size_, std::forward<Args>(args)...);
+            Relocate(new_data);
+        }
+        else {
+            elem = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+        }
+        if (++size_ == pregrow_at_) {
+            Pregrow();
+        }
+        return *elem;
+    }
+
+    void PopBack() noexcept {
+        assert(size_ > 0);
+        std::destroy_at(data_ + (size_ - 1));
+        --size_;
+    }
+
+    void Reserve(size_t capacity) {
+        if (capacity <= Capacity()) {
+            return;
+        }
+        RawMemory<T> new_data = TakeBlock(capacity);
+        Relocate(new_data);
+    }
+
+    // Уничтожает все элементы, сохраняя ёмкость и подготовленный блок
+    void Clear() noexcept {
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+private:
+    // Блок не меньше чем на capacity элементов: подготовленный, если он достаточно велик, иначе новый
+    RawMemory<T> TakeBlock(size_t capacity) {
+        if (next_.valid()) {
+            RawMemory<T> block = next_.get();
+            if (block.Capacity() >= capacity) {
+                return block;
+            }
+        }
+        return RawMemory<T>(capacity);
+    }
+
+    // Переносит элементы в new_data и переключается на него
+    void Relocate(RawMemory<T>& new_data) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            detail::UninitializedMoveN(data_.GetAddress(), size_, new_data.GetAddress());
+        }
+        else {
+            detail::UninitializedCopyN(data_.GetAddress(), size_, new_data.GetAddress());
+        }
+        std::destroy_n(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+        RawMemory<T>::Tracking::OnGrowth(size_);
+        const size_t capacity = Capacity();
+        pregrow_at_ = 2 * capacity * sizeof(T) >= PREGROW_MIN_BYTES
+                          ? std::max(static_cast<size_t>(threshold_ * static_cast<double>(capacity)), size_ + 1)
+                          : SIZE_MAX;
+    }
+
+    void Pregrow() {
+        if (next_.valid()) {
+            return;
+        }
+        try {
+            next_ = std::async(std::launch::async, [capacity = 2 * Capacity()] {
+                RawMemory<T> block(capacity);
+                // Запись в каждую страницу заставляет ядро отобразить её сейчас, а не при переносе
+                auto* bytes = reinterpret_cast<volatile unsigned char*>(block.GetAddress());
+                for (size_t offset = 0; offset < capacity * sizeof(T); offset += PAGE_BYTES) {
+                    bytes[offset] = 0;
+                }
+                return block;
+            });
+        }
+        catch (const std::system_error&) {
+            // Поток не создать: следующий блок будет выделен при переполнении, как в Vector
+        }
+    }
+
+    static constexpr size_t PAGE_BYTES = 4096;
+
+    RawMemory<T> data_;
+    size_t size_ = 0;
+    double threshold_;
+    // Размер, при достижении которого готовится следующий блок
+    size_t pregrow_at_ = SIZE_MAX;
+    std::future<RawMemory<T>> next_;
+};
\ No newline at end of file
@@ -0,0 +1,185 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <utility>
+
+// Вектор для данных, которые читают многие потоки и изредка целиком заменяет писатель (read-copy-update).
+// Читатель получает снимок — указатель на неизменяемый Vector — без блокировок и ожиданий: одна запись
+// своей эпохи и одно чтение указателя. Писатель строит новый вектор и публикует его атомарной заменой
+// указателя, а старый откладывает. Отложенный вектор разрушается, когда все читатели, которые могли
+// его видеть, закончили чтение: каждый читатель отмечает в своём слоте эпоху, в которую начал читать,
+// и вектор, снятый с публикации в эпоху e, свободен, когда ни в одном слоте нет эпохи не новее e.
+// Читатель регистрируется один раз на поток (RegisterReader) и держит не больше одного снимка за раз
+template <typename T>
+class RcuVector {
+    // Слоты читателей на разных строках кэша, чтобы записи эпох разных потоков не мешали друг другу
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch = IDLE;
+        std::atomic<bool> used = false;
+    };
+
+public:
+    static constexpr size_t DEFAULT_MAX_READERS = 256;
+
+    // Снимок вектора: пока он жив, вектор не разрушается и не меняется
+    class Snapshot {
+    public:
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        ~Snapshot() {
+            slot_.epoch.store(IDLE, std::memory_order_release);
+        }
+
+        const Vector<T>& operator*() const noexcept {
+            return *vector_;
+        }
+        const Vector<T>* operator->() const noexcept {
+            return vector_;
+        }
+
+    private:
+        friend class RcuVector;
+
+        Snapshot(Slot& slot, const Vector<T>* vector) noexcept
+            : slot_(slot), vector_(vector) {
+        }
+
+        Slot& slot_;
+        const Vector<T>* vector_;
+    };
+
+    // Слот читателя, закреплённый за одним потоком
+    class Reader {
+    public:
+        Reader(Reader&& other) noexcept
+            : owner_(std::exchange(other.owner_, nullptr)), slot_(other.slot_) {
+        }
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+
+        ~Reader() {
+            if (owner_ != nullptr) {
+                assert(slot_->epoch.load(std::memory_order_relaxed) == IDLE);
+                slot_->used.store(false, std::memory_order_release);
+            }
+        }
+
+        // Без блокировок и циклов ожидания
+        Snapshot Read() const noexcept {
+            assert(slot_->epoch.load(std::memory_order_relaxed) == IDLE);
+            // Эпоха записывается до чтения указателя: писатель, заменивший указатель раньше этого чтения,
+            // увидит либо эпоху не новее своей, либо свободный слот и новый указатель у читателя
+            slot_->epoch.store(owner_->epoch_.load());
+            return Snapshot(*slot_, owner_->current_.load());
+        }
+
+    private:
+        friend class RcuVector;
+
+        Reader(const RcuVector* owner, Slot* slot) noexcept
+            : owner_(owner), slot_(slot) {
+        }
+
+        const RcuVector* owner_;
+        Slot* slot_;
+    };
+
+    explicit RcuVector(Vector<T> initial = {}, size_t max_readers = DEFAULT_MAX_READERS)
+        : slots_(max_readers)
+        , current_(new Vector<T>(std::move(initial))) {
+    }
+
+    RcuVector(const RcuVector&) = delete;
+    RcuVector& operator=(const RcuVector&) = delete;
+
+    // Все Reader должны быть разрушены раньше
+    ~RcuVector() {
+        delete current_.load();
+    }
+
+    // Бросает std::length_error, если все max_readers слотов заняты
+    Reader RegisterReader() {
+        for (Slot& slot : slots_) {
+            bool used = false;
+            if (slot.used.compare_exchange_strong(used, true, std::memory_order_acquire)) {
+                return Reader(this, &slot);
+            }
+        }
+        throw std::length_error("RcuVector has no free reader slots");
+    }
+
+    // Заменяет опубликованный вектор на v. Старый разрушается, когда его перестанут читать:
+    // здесь или в одной из следующих публикаций, или в Reclaim
+    void Publish(Vector<T> v) {
+        std::lock_guard guard(writer_mutex_);
+        PublishLocked(std::move(v));
+    }
+
+    // Публикует копию текущего вектора, изменённую update(Vector<T>&). Писатели выполняются по очереди,
+    // поэтому изменения двух Update не теряются
+    template <typename F>
+    void Update(F update) {
+        std::lock_guard guard(writer_mutex_);
+        Vector<T> next = *current_.load();
+        update(next);
+        PublishLocked(std::move(next));
+    }
+
+    // Разрушает отложенные векторы, которые уже никто не читает, и возвращает, сколько их осталось
+    size_t Reclaim() {
+        std::lock_guard guard(writer_mutex_);
+        ReclaimLocked();
+        return retired_.Size();
+    }
+
+private:
+    static constexpr uint64_t IDLE = 0;
+
+    struct Retired {
+        std::unique_ptr<const Vector<T>> vector;
+        // Эпоха, в которую вектор снят с публикации
+        uint64_t epoch = 0;
+    };
+
+    void PublishLocked(Vector<T> v) {
+        // После замены указателя ничто не должно бросать: старый вектор ещё могут читать
+        retired_.Reserve(retired_.Size() + 1);
+        std::unique_ptr<const Vector<T>> previous(current_.exchange(new Vector<T>(std::move(v))));
+        retired_.PushBack(Retired{std::move(previous), epoch_.fetch_add(1)});
+        ReclaimLocked();
+    }
+
+    void ReclaimLocked() {
+        uint64_t oldest = UINT64_MAX;
+        for (const Slot& slot : slots_) {
+            const uint64_t epoch = slot.epoch.load();
+            if (epoch != IDLE) {
+                oldest = std::min(oldest, epoch);
+            }
+        }
+        // Эпохи отложенных векторов возрастают, поэтому свободные образуют начало списка
+        size_t freed = 0;
+        while (freed < retired_.Size() && retired_[freed].epoch < oldest) {
+            ++freed;
+        }
+        std::move(retired_.begin() + freed, retired_.end(), retired_.begin());
+        retired_.Resize(retired_.Size() - freed);
+    }
+
+    Vector<Slot> slots_;
+    std::atomic<const Vector<T>*> current_;
+    // Начинается с 1, потому что 0 в слоте означает, что читатель не читает
+    std::atomic<uint64_t> epoch_ = 1;
+    std::mutex writer_mutex_;
+    Vector<Retired> retired_;
+};
\ No newline at end of file
@@ -0,0 +1,339 @@
+#pragma once
+#include "parallel.h"
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Префиксные суммы и гистограммы над векторами чисел, например для построения смещений CSR:
+//     Histogram(rows, row_count, counts);
+//     const size_t total = ExclusiveScan(counts, offsets);
+// Параллельные варианты работают в два прохода: сначала каждый поток считает сумму своего участка,
+// затем участки сканируются одновременно, начиная с суммы всех предыдущих. Для чисел с плавающей точкой
+// порядок сложения у векторных и параллельных вариантов другой, и результат может отличаться
+// от последовательного в последних разрядах
+
+namespace detail {
+
+    // Участок, который параллельным алгоритмам имеет смысл отдавать отдельному потоку
+    inline constexpr size_t PARALLEL_SCAN_CHUNK = 64 * 1024;
+
+    // До стольких корзин гистограмма ведётся в четырёх копиях, которые вместе помещаются в L1
+    inline constexpr size_t HISTOGRAM_SPLIT_BINS = 1024;
+
+    // Префиксная сумма четырёх 32-битных элементов в регистре SSE: два сдвига со сложением
+    template <typename T, typename = void>
+    struct ScanLanes {
+        static constexpr bool ENABLED = false;
+    };
+
+#if defined(__SSE2__)
+    template <typename T>
+    struct ScanLanes<T, std::enable_if_t<std::is_integral_v<T> && sizeof(T) == 4>> {
+        static constexpr bool ENABLED = true;
+        using Register = __m128i;
+
+        static Register Load(const T* items) noexcept {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(items));
+        }
+        static void Store(T* items, Register x) noexcept {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(items), x);
+        }
+        static Register Broadcast(T value) noexcept {
+            return _mm_set1_epi32(static_cast<int>(value));
+        }
+        static Register Add(Register x, Register y) noexcept {
+            return _mm_add_epi32(x, y);
+        }
+        // Сдвиг на LANES элементов к старшим позициям с заполнением нулями
+        template <int LANES>
+        static Register Shift(Register x) noexcept {
+            return _mm_slli_si128(x, LANES * 4);
+        }
+        static Register BroadcastLast(Register x) noexcept {
+            return _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        static T First(Register x) noexcept {
+            return static_cast<T>(_mm_cvtsi128_si32(x));
+        }
+    };
+
+    template <>
+    struct ScanLanes<float, void> {
+        static constexpr bool ENABLED = true;
+        using Register = __m128;
+
+        static Register Load(const float* items) noexcept {
+            return _mm_loadu_ps(items);
+        }
+        static void Store(float* items, Register x) noexcept {
+            _mm_storeu_ps(items, x);
+        }
+        static Register Broadcast(float value) noexcept {
+            return _mm_set1_ps(value);
+        }
+        static Register Add(Register x, Register y) noexcept {
+            return _mm_add_ps(x, y);
+        }
+        template <int LANES>
+        static Register Shift(Register x) noexcept {
+            return _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(x), LANES * 4));
+        }
+        static Register BroadcastLast(Register x) noexcept {
+            return _mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+        static float First(Register x) noexcept {
+            return _mm_cvtss_f32(x);
+        }
+    };
+#endif
+
+    // Префиксная сумма size элементов, начиная с carry; возвращает carry плюс сумму всех элементов.
+    // Включающая: out[i] = carry + in[0] + ... + in[i], исключающая — без in[i]. in и out могут совпадать
+    template <bool INCLUSIVE, typename T>
+    T ScanRange(const T* in, T* out, size_t size, T carry) {
+        size_t i = 0;
+        if constexpr (ScanLanes<T>::ENABLED) {
+            using Lanes = ScanLanes<T>;
+            auto offset = Lanes::Broadcast(carry);
+            for (; i + 4 <= size; i += 4) {
+                const auto x = Lanes::Load(in + i);
+                // Исключающая сумма строится из сдвинутого на один элемент регистра, а не вычитанием,
+                // чтобы для float не терять точность
+                auto prefix = INCLUSIVE ? x : Lanes::template Shift<1>(x);
+                prefix = Lanes::Add(prefix, Lanes::template Shift<1>(prefix));
+                prefix = Lanes::Add(prefix, Lanes::template Shift<2>(prefix));
+                const auto result = Lanes::Add(prefix, offset);
+                Lanes::Store(out + i, result);
+                offset = Lanes::BroadcastLast(INCLUSIVE ? result : Lanes::Add(result, x));
+            }
+            carry = Lanes::First(offset);
+        }
+        for (; i < size; ++i) {
+            const T item = in[i];
+            if constexpr (INCLUSIVE) {
+                carry += item;
+                out[i] = carry;
+            }
+            else {
+                out[i] = carry;
+                carry += item;
+            }
+        }
+        return carry;
+    }
+
+    // Сумма size элементов в четырёх независимых цепочках сложений
+    template <typename T>
+    T SumRange(const T* in, size_t size) {
+        T sums[4] = {};
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            for (size_t lane = 0; lane < 4; ++lane) {
+                sums[lane] += in[i + lane];
+            }
+        }
+        for (; i < size; ++i) {
+            sums[0] += in[i];
+        }
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+
+    template <bool INCLUSIVE, typename T>
+    T ParallelScan(const Vector<T>& in, Vector<T>& out, T init, size_t threads) {
+        const size_t size = in.Size();
+        if (&out != &in) {
+            out.Resize(size);
+        }
+        if (threads == 0) {
+            threads = DefaultThreadCount();
+        }
+        const size_t chunks = std::clamp<size_t>(size / PARALLEL_SCAN_CHUNK, 1, threads);
+        if (chunks == 1) {
+            return ScanRange<INCLUSIVE>(in.begin(), out.begin(), size, init);
+        }
+        const auto chunk_begin = [size, chunks](size_t chunk) {
+            return size * chunk / chunks;
+        };
+        // Сначала суммы участков, затем вместо них — суммы всех предыдущих участков
+        Vector<T> carries(chunks);
+        ParallelFor(
+            0, chunks,
+            [&](size_t first, size_t last) {
+                for (size_t chunk = first; chunk < last; ++chunk) {
+                    carries[chunk] = SumRange(in.begin() + chunk_begin(chunk), chunk_begin(chunk + 1) - chunk_begin(chunk));
+                }
+            },
+            chunks, 1);
+        const T total = ScanRange<false>(carries.begin(), carries.begin(), chunks, init);
+        ParallelFor(
+            0, chunks,
+            [&](size_t first, size_t last) {
+                for (size_t chunk = first; chunk < last; ++chunk) {
+                    const size_t begin = chunk_begin(chunk);
+                    ScanRange<INCLUSIVE>(in.begin() + begin, out.begin() + begin, chunk_begin(chunk + 1) - begin,
+                                         carries[chunk]);
+                }
+            },
+            chunks, 1);
+        return total;
+    }
+
+    // Прибавляет к counts[0..bins] число индексов bin_of(i) для i из [from, to); индекс bins означает,
+    // что элемент не попал ни в одну корзину. При небольшом числе корзин соседние элементы считаются
+    // в четырёх копиях гистограммы: иначе серия одинаковых ключей упирается в задержку
+    // чтения только что записанного счётчика
+    template <typename BinOf>
+    void CountBins(size_t from, size_t to, size_t bins, BinOf bin_of, size_t* counts) {
+        const size_t slots = bins + 1;
+        if (bins > HISTOGRAM_SPLIT_BINS || to - from < 4 * slots) {
+            for (size_t i = from; i < to; ++i) {
+                ++counts[bin_of(i)];
+            }
+            return;
+        }
+        Vector<size_t> partial(3 * slots);
+        size_t* copies[4] = {counts, partial.begin(), partial.begin() + slots, partial.begin() + 2 * slots};
+        size_t i = from;
+        for (; i + 4 <= to; i += 4) {
+            for (size_t copy = 0; copy < 4; ++copy) {
+                ++copies[copy][bin_of(i + copy)];
+            }
+        }
+        for (; i < to; ++i) {
+            ++counts[bin_of(i)];
+        }
+        for (size_t bin = 0; bin < slots; ++bin) {
+            counts[bin] += copies[1][bin] + copies[2][bin] + copies[3][bin];
+        }
+    }
+
+    template <typename BinOf>
+    void Histogram(size_t size, size_t bins, BinOf bin_of, Vector<size_t>& counts, size_t threads) {
+        // Лишний счётчик в конце собирает элементы вне корзин и потом отбрасывается
+        counts.Clear();
+        counts.Resize(bins + 1);
+        if (threads == 0) {
+            threads = DefaultThreadCount();
+        }
+        const size_t chunks = std::clamp<size_t>(size / PARALLEL_SCAN_CHUNK, 1, threads);
+        if (chunks == 1) {
+            CountBins(0, size, bins, bin_of, counts.begin());
+        }
+        else {
+            Vector<size_t> partial(chunks * (bins + 1));
+            ParallelFor(
+                0, chunks,
+                [&](size_t first, size_t last) {
+                    for (size_t chunk = first; chunk < last; ++chunk) {
+                        CountBins(size * chunk / chunks, size * (chunk + 1) / chunks, bins, bin_of,
+                                  partial.begin() + chunk * (bins + 1));
+                    }
+                },
+                chunks, 1);
+            for (size_t chunk = 0; chunk < chunks; ++chunk) {
+                const size_t* chunk_counts = partial.begin() + chunk * (bins + 1);
+                ADVANCED_VECTOR_IVDEP
+                for (size_t bin = 0; bin < bins; ++bin) {
+                    counts[bin] += chunk_counts[bin];
+                }
+            }
+        }
+        counts.PopBack();
+    }
+
+    // Номер корзины для i-го ключа
+    template <typename Key>
+    auto KeyBins(const Vector<Key>& keys, [[maybe_unused]] size_t bins) {
+        static_assert(std::is_integral_v<Key>, "Histogram needs integral keys");
+        return [items = keys.begin(), bins](size_t i) {
+            assert(static_cast<size_t>(items[i]) < bins);
+            return static_cast<size_t>(items[i]);
+        };
+    }
+
+    // Номер корзины для i-го значения или bins, если оно вне [low, high)
+    template <typename T>
+    auto RangeBins(const Vector<T>& values, T low, T high, size_t bins) {
+        static_assert(std::is_arithmetic_v<T>, "Histogram needs arithmetic values");
+        assert(low < high && bins > 0);
+        const double scale = static_cast<double>(bins) / (static_cast<double>(high) - static_cast<double>(low));
+        return [items = values.begin(), low, high, bins, scale](size_t i) {
+            const T value = items[i];
+            if (!(value >= low && value < high)) {
+                return bins;
+            }
+            // Округление может дать bins для значений у самой верхней границы
+            const size_t bin = static_cast<size_t>((static_cast<double>(value) - static_cast<double>(low)) * scale);
+            return std::min(bin, bins - 1);
+        };
+    }
+
+}  // namespace detail
+
+// out[i] = in[0] + ... + in[i]; возвращает сумму всех элементов. out может совпадать с in.
+// 32-битные целые и float суммируются по 4 элемента в регистре SSE
+template <typename T>
+T InclusiveScan(const Vector<T>& in, Vector<T>& out) {
+    static_assert(std::is_arithmetic_v<T>, "InclusiveScan needs arithmetic elements");
+    if (&out != &in) {
+        out.Resize(in.Size());
+    }
+    return detail::ScanRange<true>(in.begin(), out.begin(), in.Size(), T());
+}
+
+// out[i] = init + in[0] + ... + in[i - 1]; возвращает init плюс сумму всех элементов —
+// смещение конца последнего отрезка в CSR. out может совпадать с in
+template <typename T>
+T ExclusiveScan(const Vector<T>& in, Vector<T>& out, T init = T()) {
+    static_assert(std::is_arithmetic_v<T>, "ExclusiveScan needs arithmetic elements");
+    if (&out != &in) {
+        out.Resize(in.Size());
+    }
+    return detail::ScanRange<false>(in.begin(), out.begin(), in.Size(), init);
+}
+
+// InclusiveScan на threads потоках (0 — по числу ядер); вектор короче PARALLEL_SCAN_CHUNK на поток
+// сканируется в вызывающем потоке
+template <typename T>
+T ParallelInclusiveScan(const Vector<T>& in, Vector<T>& out, size_t threads = 0) {
+    static_assert(std::is_arithmetic_v<T>, "InclusiveScan needs arithmetic elements");
+    return detail::ParallelScan<true>(in, out, T(), threads);
+}
+
+template <typename T>
+T ParallelExclusiveScan(const Vector<T>& in, Vector<T>& out, T init = T(), size_t threads = 0) {
+    static_assert(std::is_arithmetic_v<T>, "ExclusiveScan needs arithmetic elements");
+    return detail::ParallelScan<false>(in, out, init, threads);
+}
+
+// counts[k] — число ключей, равных k; counts получает bins элементов. Все ключи должны быть меньше bins
+template <typename Key>
+void Histogram(const Vector<Key>& keys, size_t bins, Vector<size_t>& counts) {
+    detail::Histogram(keys.Size(), bins, detail::KeyBins(keys, bins), counts, 1);
+}
+
+// Гистограмма значений из [low, high), разбитого на bins равных корзин; значения вне диапазона
+// не учитываются
+template <typename T>
+void Histogram(const Vector<T>& values, T low, T high, size_t bins, Vector<size_t>& counts) {
+    detail::Histogram(values.Size(), bins, detail::RangeBins(values, low, high, bins), counts, 1);
+}
+
+// Histogram на threads потоках (0 — по числу ядер): каждый поток считает свою гистограмму, затем они складываются
+template <typename Key>
+void ParallelHistogram(const Vector<Key>& keys, size_t bins, Vector<size_t>& counts, size_t threads = 0) {
+    detail::Histogram(keys.Size(), bins, detail::KeyBins(keys, bins), counts, threads);
+}
+
+template <typename T>
+void ParallelHistogram(const Vector<T>& values, T low, T high, size_t bins, Vector<size_t>& counts,
+                       size_t threads = 0) {
+    detail::Histogram(values.Size(), bins, detail::RangeBins(values, low, high, bins), counts, threads);
+}
\ No newline at end of file
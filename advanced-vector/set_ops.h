@@ -0,0 +1,247 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Операции над множествами, представленными отсортированными векторами без повторов (см. Unique).
+// Результат записывается в out: прежнее содержимое заменяется, а память out выделяется не более
+// одного раза — сразу под наибольший возможный размер результата. out не должен совпадать с операндами
+
+// Во столько раз и больше один операнд пересечения должен быть длиннее другого, чтобы короткий
+// искался в длинном экспоненциальным поиском, а не обходился вместе с ним слиянием
+inline constexpr size_t GALLOP_RATIO = 32;
+
+namespace detail {
+
+    // Запись результата в out. Для тривиально копируемых элементов out сразу получает наибольший возможный
+    // размер и ещё одну ячейку, куда PushIf пишет отброшенные элементы, когда результат уже заполнен.
+    // Элементы пишутся по указателю без проверки ёмкости, а в конце лишние отбрасываются.
+    // Иначе элементы добавляются через PushBack в заранее зарезервированную память
+    template <typename T>
+    class SetOutput {
+    public:
+        static constexpr bool DIRECT = std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>;
+
+        SetOutput(Vector<T>& out, size_t max_size)
+            : out_(out) {
+            if constexpr (DIRECT) {
+                // Старые элементы не нужны, и переносить их в новый буфер незачем. Элементы не инициализируются:
+                // обнуление всего наибольшего результата было бы лишним проходом по памяти
+                out.Clear();
+                next_ = out.ExtendUninitialized(max_size + 1);
+            }
+            else {
+                out.Clear();
+                out.Reserve(max_size);
+            }
+        }
+
+        SetOutput(const SetOutput&) = delete;
+        SetOutput& operator=(const SetOutput&) = delete;
+
+        ~SetOutput() {
+            if constexpr (DIRECT) {
+                out_.Resize(static_cast<size_t>(next_ - out_.begin()));
+            }
+        }
+
+        void Push(const T& item) {
+            if constexpr (DIRECT) {
+                *next_++ = item;
+            }
+            else {
+                out_.PushBack(item);
+            }
+        }
+
+        // Записывает item, если keep истинно; для DIRECT — без ветвления. Отброшенный элемент пишется
+        // в следующую ячейку, не сдвигая позицию, поэтому запасной ячейки хватает при любом числе вызовов
+        void PushIf(const T& item, bool keep) {
+            if constexpr (DIRECT) {
+                *next_ = item;
+                next_ += keep;
+            }
+            else if (keep) {
+                out_.PushBack(item);
+            }
+        }
+
+    private:
+        Vector<T>& out_;
+        T* next_ = nullptr;
+    };
+
+    // Первая позиция в [from, size), где items[pos] >= value. Шаг поиска удваивается от from,
+    // так что соседние запросы обходятся O(log расстояния), а не O(log size)
+    template <typename T>
+    size_t GallopLowerBound(const T* items, size_t from, size_t size, const T& value) {
+        size_t step = 1;
+        size_t low = from;
+        while (from + step < size && items[from + step] < value) {
+            low = from + step;
+            step *= 2;
+        }
+        const size_t high = std::min(from + step + 1, size);
+        return static_cast<size_t>(std::lower_bound(items + low, items + high, value) - items);
+    }
+
+    template <typename T>
+    void IntersectGalloping(const Vector<T>& small, const Vector<T>& large, SetOutput<T>& out) {
+        size_t pos = 0;
+        for (const T& item : small) {
+            pos = GallopLowerBound(large.begin(), pos, large.Size(), item);
+            if (pos == large.Size()) {
+                return;
+            }
+            out.PushIf(item, !(item < large[pos]));
+        }
+    }
+
+    // Блоки по 4 элемента из каждого вектора сравниваются все со всеми за 4 сравнения SSE:
+    // второй блок сравнивается с первым в 4 циклических сдвигах. Блок с меньшим максимумом сдвигается,
+    // поэтому ветвления зависят от данных раз в 4 элемента, а не на каждом шаге слияния
+    template <typename T>
+    void IntersectBlocks(const Vector<T>& a, const Vector<T>& b, SetOutput<T>& out) {
+        const T* a_items = a.begin();
+        const T* b_items = b.begin();
+        size_t i = 0;
+        size_t j = 0;
+#if defined(__SSE2__)
+        if constexpr (std::is_integral_v<T> && sizeof(T) == 4) {
+            while (i + 4 <= a.Size() && j + 4 <= b.Size()) {
+                const __m128i a_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_items + i));
+                const __m128i b_block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b_items + j));
+                const __m128i equal = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi32(a_block, b_block),
+                                 _mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(b_block, _MM_SHUFFLE(0, 3, 2, 1)))),
+                    _mm_or_si128(_mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(b_block, _MM_SHUFFLE(1, 0, 3, 2))),
+                                 _mm_cmpeq_epi32(a_block, _mm_shuffle_epi32(b_block, _MM_SHUFFLE(2, 1, 0, 3)))));
+                const int mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+                for (int k = 0; k < 4; ++k) {
+                    out.PushIf(a_items[i + k], (mask >> k) & 1);
+                }
+                const T a_max = a_items[i + 3];
+                const T b_max = b_items[j + 3];
+                i += a_max <= b_max ? 4 : 0;
+                j += b_max <= a_max ? 4 : 0;
+            }
+        }
+#endif
+        while (i < a.Size() && j < b.Size()) {
+            const bool less = a_items[i] < b_items[j];
+            const bool greater = b_items[j] < a_items[i];
+            out.PushIf(a_items[i], !less && !greater);
+            i += !greater;
+            j += !less;
+        }
+    }
+
+}  // namespace detail
+
+// Удаляет повторы из отсортированного вектора, сохраняя первый элемент каждой серии
+template <typename T>
+void Unique(Vector<T>& v) {
+    if (v.Size() < 2) {
+        return;
+    }
+    if constexpr (detail::SetOutput<T>::DIRECT) {
+        // Без ветвлений: элемент пишется всегда, а позиция записи сдвигается, только если он новый.
+        // Сравнение идёт с предыдущим входным элементом в регистре, а не с только что записанным
+        T* items = v.begin();
+        T last = items[0];
+        size_t kept = 1;
+        for (size_t i = 1; i < v.Size(); ++i) {
+            const T item = items[i];
+            items[kept] = item;
+            kept += !(item == last);
+            last = item;
+        }
+        v.Resize(kept);
+    }
+    else {
+        const size_t kept = static_cast<size_t>(std::unique(v.begin(), v.end()) - v.begin());
+        while (v.Size() > kept) {
+            v.PopBack();
+        }
+    }
+}
+
+// out — пересечение a и b. Для 4-байтных целых сравнивает блоки инструкциями SSE, а при длине одного операнда
+// в GALLOP_RATIO и более раз больше другой ищет элементы короткого в длинном экспоненциальным поиском
+template <typename T>
+void Intersect(const Vector<T>& a, const Vector<T>& b, Vector<T>& out) {
+    assert(&out != &a && &out != &b);
+    detail::SetOutput<T> output(out, std::min(a.Size(), b.Size()));
+    const Vector<T>& small = a.Size() <= b.Size() ? a : b;
+    const Vector<T>& large = a.Size() <= b.Size() ? b : a;
+    if (small.Size() * GALLOP_RATIO <= large.Size()) {
+        detail::IntersectGalloping(small, large, output);
+    }
+    else {
+        detail::IntersectBlocks(a, b, output);
+    }
+}
+
+// out — объединение a и b. Слияние без ветвлений по данным: на каждом шаге пишется меньший из элементов,
+// а сдвигается тот операнд (или оба), в котором он стоял
+template <typename T>
+void Union(const Vector<T>& a, const Vector<T>& b, Vector<T>& out) {
+    assert(&out != &a && &out != &b);
+    detail::SetOutput<T> output(out, a.Size() + b.Size());
+    size_t i = 0;
+    size_t j = 0;
+    while (i < a.Size() && j < b.Size()) {
+        const T& a_item = a[i];
+        const T& b_item = b[j];
+        const bool a_first = !(b_item < a_item);
+        const bool b_first = !(a_item < b_item);
+        output.Push(a_first ? a_item : b_item);
+        i += a_first;
+        j += b_first;
+    }
+    for (; i < a.Size(); ++i) {
+        output.Push(a[i]);
+    }
+    for (; j < b.Size(); ++j) {
+        output.Push(b[j]);
+    }
+}
+
+// out — разность a и b. Если b в GALLOP_RATIO и более раз короче, его элементы ищутся в a экспоненциальным
+// поиском, а участки a между ними копируются целиком
+template <typename T>
+void Difference(const Vector<T>& a, const Vector<T>& b, Vector<T>& out) {
+    assert(&out != &a && &out != &b);
+    detail::SetOutput<T> output(out, a.Size());
+    size_t i = 0;
+    if (b.Size() * GALLOP_RATIO <= a.Size()) {
+        for (const T& item : b) {
+            const size_t pos = detail::GallopLowerBound(a.begin(), i, a.Size(), item);
+            for (; i < pos; ++i) {
+                output.Push(a[i]);
+            }
+            i += i < a.Size() && !(item < a[i]);
+        }
+    }
+    else {
+        size_t j = 0;
+        while (i < a.Size() && j < b.Size()) {
+            const bool less = a[i] < b[j];
+            const bool greater = b[j] < a[i];
+            output.PushIf(a[i], less);
+            i += !greater;
+            j += !less;
+        }
+    }
+    for (; i < a.Size(); ++i) {
+        output.Push(a[i]);
+    }
+}
\ No newline at end of file
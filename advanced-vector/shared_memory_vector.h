@@ -0,0 +1,259 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+
+// Вектор в именованном сегменте разделяемой памяти POSIX (shm_open + mmap) для данных, которые
+// нужны нескольким процессам. Процесс-загрузчик создаёт сегмент (Create) на заданную ёмкость,
+// заполняет его и запечатывает (Seal), остальные открывают его только для чтения (Open)
+// и читают те же страницы без копирования. Сегмент в разных процессах отображается по разным адресам,
+// поэтому в нём нет указателей: заголовок хранит смещение данных от начала сегмента.
+// Ёмкость задаётся при создании, попытка её превысить бросает std::length_error.
+// Сегмент живёт, пока его не удалят через Unlink, даже если все процессы закрыли свои отображения
+template <typename T>
+class SharedMemoryVector {
+    // Элементы читаются другими процессами побайтно, без конструкторов
+    static_assert(std::is_trivially_copyable_v<T>, "SharedMemoryVector requires a trivially copyable type");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory requires lock-free atomics");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    // Создаёт сегмент name (вида "/lookup") на capacity элементов и отображает его для записи.
+    // Бросает std::system_error, если сегмент с таким именем уже есть, и std::length_error,
+    // если capacity элементов не помещаются в адресное пространство
+    static SharedMemoryVector Create(const std::string& name, size_t capacity) {
+        if (capacity > (SIZE_MAX - DataOffset()) / sizeof(T)) {
+            throw std::length_error("SharedMemoryVector capacity is too large");
+        }
+        const size_t bytes = DataOffset() + capacity * sizeof(T);
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        }
+        if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            const int error = errno;
+            close(fd);
+            shm_unlink(name.c_str());
+            throw std::system_error(error, std::generic_category(), "ftruncate " + name);
+        }
+        void* address = nullptr;
+        try {
+            address = Map(fd, bytes, PROT_READ | PROT_WRITE, name);
+        }
+        catch (...) {
+            // Иначе сегмент остался бы, и повторные попытки получали бы EEXIST
+            shm_unlink(name.c_str());
+            throw;
+        }
+        SharedMemoryVector v(address, bytes, true);
+        // Пока заголовок не запечатан, читатели не принимают сегмент
+        Header* header = std::construct_at(v.header_);
+        header->magic = MAGIC;
+        header->element_size = sizeof(T);
+        header->element_align = alignof(T);
+        header->capacity = capacity;
+        header->data_offset = DataOffset();
+        return v;
+    }
+
+    // Отображает запечатанный сегмент name только для чтения. Бросает std::system_error,
+    // если сегмента нет, и std::runtime_error, если он не запечатан или хранит другой тип
+    static SharedMemoryVector Open(const std::string& name) {
+        const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+        }
+        struct stat info{};
+        if (fstat(fd, &info) != 0) {
+            const int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat " + name);
+        }
+        const size_t bytes = static_cast<size_t>(info.st_size);
+        if (bytes < DataOffset()) {
+            close(fd);
+            throw std::runtime_error("Invalid shared memory vector: " + name);
+        }
+        SharedMemoryVector v(Map(fd, bytes, PROT_READ, name), bytes, false);
+        const Header& header = *v.header_;
+        // Парная запись в Seal: только после неё остальные поля заголовка и элементы записаны целиком
+        if (header.sealed.load(std::memory_order_acquire) == 0) {
+            throw std::runtime_error("Shared memory vector is not sealed: " + name);
+        }
+        const uint64_t size = header.size.load(std::memory_order_relaxed);
+        if (header.magic != MAGIC || header.element_size != sizeof(T) || header.element_align != alignof(T)
+            || header.data_offset != DataOffset() || header.capacity > (bytes - DataOffset()) / sizeof(T)
+            || size > header.capacity) {
+            throw std::runtime_error("Invalid shared memory vector: " + name);
+        }
+        v.size_ = static_cast<size_t>(size);
+        return v;
+    }
+
+    // Удаляет имя сегмента. Уже отображённые сегменты остаются доступны до закрытия
+    static void Unlink(const std::string& name) {
+        if (shm_unlink(name.c_str()) != 0) {
+            throw std::system_error(errno, std::generic_category(), "shm_unlink " + name);
+        }
+    }
+
+    SharedMemoryVector(const SharedMemoryVector&) = delete;
+    SharedMemoryVector& operator=(const SharedMemoryVector&) = delete;
+
+    SharedMemoryVector(SharedMemoryVector&& other) noexcept
+        : header_(std::exchange(other.header_, nullptr))
+        , bytes_(std::exchange(other.bytes_, 0))
+        , size_(std::exchange(other.size_, 0))
+        , writable_(std::exchange(other.writable_, false)) {
+    }
+
+    SharedMemoryVector& operator=(SharedMemoryVector&& rhs) noexcept {
+        if (this != &rhs) {
+            SharedMemoryVector tmp(std::move(rhs));
+            std::swap(header_, tmp.header_);
+            std::swap(bytes_, tmp.bytes_);
+            std::swap(size_, tmp.size_);
+            std::swap(writable_, tmp.writable_);
+        }
+        return *this;
+    }
+
+    ~SharedMemoryVector() {
+        if (header_ != nullptr) {
+            munmap(header_, bytes_);
+        }
+    }
+
+    const_iterator begin() const noexcept {
+        return Data();
+    }
+    const_iterator end() const noexcept {
+        return Data() + size_;
+    }
+
+    size_t Size() const noexcept {
+        return size_;
+    }
+
+    size_t Capacity() const noexcept {
+        return header_->capacity;
+    }
+
+    // Запечатан ли сегмент: после этого он доступен читателям и не меняется
+    bool IsSealed() const noexcept {
+        return !writable_;
+    }
+
+    // Чтение одинаково для создателя и читателей. Изменять элементы можно только через Mutable
+    const T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    // Изменяемый элемент для создателя до Seal. Бросает std::logic_error, если сегмент запечатан
+    // или открыт через Open: его страницы отображены только для чтения
+    T& Mutable(size_t index) {
+        CheckWritable();
+        assert(index < size_);
+        return Data()[index];
+    }
+
+    void PushBack(const T& value) {
+        Append(&value, 1);
+    }
+
+    // Дописывает count элементов одним копированием
+    void Append(const T* values, size_t count) {
+        CheckWritable();
+        if (count > Capacity() - size_) {
+            throw std::length_error("SharedMemoryVector capacity exceeded");
+        }
+        if (count > 0) {
+            std::memcpy(static_cast<void*>(Data() + size_), values, count * sizeof(T));
+            size_ += count;
+        }
+    }
+
+    // Публикует размер и элементы для Open и переотображает сегмент только для чтения
+    void Seal() {
+        CheckWritable();
+        header_->size.store(size_, std::memory_order_relaxed);
+        header_->sealed.store(1, std::memory_order_release);
+        if (mprotect(header_, bytes_, PROT_READ) != 0) {
+            throw std::system_error(errno, std::generic_category(), "mprotect");
+        }
+        writable_ = false;
+    }
+
+private:
+    // Заголовок в начале сегмента. Только числа и смещения: процессы видят сегмент по разным адресам
+    struct Header {
+        uint64_t magic = 0;
+        uint64_t element_size = 0;
+        uint64_t element_align = 0;
+        uint64_t capacity = 0;
+        uint64_t data_offset = 0;
+        std::atomic<uint64_t> size = 0;
+        std::atomic<uint32_t> sealed = 0;
+    };
+
+    // "ADVVECSH"
+    static constexpr uint64_t MAGIC = 0x4853434556564441;
+
+    // Данные начинаются с отдельной строки кэша после заголовка
+    static constexpr size_t DataOffset() noexcept {
+        constexpr size_t ALIGN = alignof(T) > 64 ? alignof(T) : 64;
+        return (sizeof(Header) + ALIGN - 1) / ALIGN * ALIGN;
+    }
+
+    static void* Map(int fd, size_t bytes, int protection, const std::string& name) {
+        void* address = mmap(nullptr, bytes, protection, MAP_SHARED, fd, 0);
+        // Отображение держит сегмент и без дескриптора
+        const int error = errno;
+        close(fd);
+        if (address == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(), "mmap " + name);
+        }
+        return address;
+    }
+
+    SharedMemoryVector(void* address, size_t bytes, bool writable) noexcept
+        : header_(static_cast<Header*>(address)), bytes_(bytes), writable_(writable) {
+    }
+
+    void CheckWritable() const {
+        if (!writable_) {
+            throw std::logic_error("SharedMemoryVector is read-only");
+        }
+    }
+
+    T* Data() const noexcept {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(header_) + header_->data_offset);
+    }
+
+    Header* header_ = nullptr;
+    size_t bytes_ = 0;
+    size_t size_ = 0;
+    bool writable_ = false;
+};
+
+#endif
\ No newline at end of file
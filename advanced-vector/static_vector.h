@@ -0,0 +1,222 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Вектор не более чем из N элементов, хранящихся внутри самого объекта: без выделений памяти
+// и с размером самого узкого целого типа, вмещающего N. Интерфейс повторяет Vector,
+// попытка превысить N бросает std::length_error
+template <typename T, size_t N>
+class StaticVector {
+    static_assert(N > 0, "StaticVector must have positive capacity");
+
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+    using SizeType = std::conditional_t<N <= UINT8_MAX, uint8_t,
+                     std::conditional_t<N <= UINT16_MAX, uint16_t,
+                     std::conditional_t<N <= UINT32_MAX, uint32_t, size_t>>>;
+
+    constexpr StaticVector() noexcept {
+    }
+
+    constexpr explicit StaticVector(size_t size) {
+        Resize(size);
+    }
+
+    constexpr StaticVector(const StaticVector& other) {
+        detail::UninitializedCopyN(other.begin(), other.size_, begin());
+        size_ = other.size_;
+    }
+
+    constexpr StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        detail::UninitializedMoveN(other.begin(), other.size_, begin());
+        size_ = other.size_;
+    }
+
+    constexpr ~StaticVector() {
+        std::destroy_n(begin(), size_);
+    }
+
+    constexpr StaticVector& operator=(const StaticVector& rhs) {
+        if (this != &rhs) {
+            Assign(rhs.begin(), rhs.size_);
+        }
+        return *this;
+    }
+
+    constexpr StaticVector& operator=(StaticVector&& rhs) noexcept(std::is_nothrow_move_assignable_v<T>
+                                                                 && std::is_nothrow_move_constructible_v<T>) {
+        if (this != &rhs) {
+            Assign(std::make_move_iterator(rhs.begin()), rhs.size_);
+        }
+        return *this;
+    }
+
+    constexpr iterator begin() noexcept {
+        return items_;
+    }
+    constexpr iterator end() noexcept {
+        return items_ + size_;
+    }
+    constexpr const_iterator begin() const noexcept {
+        return items_;
+    }
+    constexpr const_iterator end() const noexcept {
+        return items_ + size_;
+    }
+    constexpr const_iterator cbegin() const noexcept {
+        return items_;
+    }
+    constexpr const_iterator cend() const noexcept {
+        return items_ + size_;
+    }
+
+    // Память под N элементов уже есть, поэтому Reserve лишь проверяет, что new_capacity не больше N
+    constexpr void Reserve(size_t new_capacity) {
+        CheckCapacity(new_capacity);
+    }
+
+    constexpr void Resize(size_t new_size) {
+        CheckCapacity(new_size);
+        if (new_size < size_) {
+            std::destroy_n(items_ + new_size, size_ - new_size);
+        }
+        else {
+            detail::UninitializedValueConstructN(items_ + size_, new_size - size_);
+        }
+        size_ = static_cast<SizeType>(new_size);
+    }
+
+    constexpr void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    constexpr void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        CheckCapacity(size_ + 1u);
+        T* elem = std::construct_at(items_ + size_, std::forward<Args>(args)...);
+        ++size_;
+        return *elem;
+    }
+
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        const size_t index = pos - begin();
+        if (index == size_) {
+            EmplaceBack(std::forward<Args>(args)...);
+            return items_ + index;
+        }
+        CheckCapacity(size_ + 1u);
+        T elem(std::forward<Args>(args)...);
+        std::construct_at(items_ + size_, std::move(items_[size_ - 1]));
+        ++size_;
+        std::move_backward(items_ + index, items_ + (size_ - 2), items_ + (size_ - 1));
+        items_[index] = std::move(elem);
+        return items_ + index;
+    }
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    constexpr iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        const size_t index = pos - begin();
+        std::move(items_ + (index + 1), items_ + size_, items_ + index);
+        PopBack();
+        return items_ + index;
+    }
+
+    constexpr void PopBack() noexcept {
+        assert(size_ > 0);
+        --size_;
+        std::destroy_at(items_ + size_);
+    }
+
+    // В отличие от Vector::Swap переставляет сами элементы, то есть работает за O(size)
+    constexpr void Swap(StaticVector& other) noexcept(std::is_nothrow_swappable_v<T>
+                                                      && std::is_nothrow_move_constructible_v<T>) {
+        StaticVector& shorter = size_ < other.size_ ? *this : other;
+        StaticVector& longer = size_ < other.size_ ? other : *this;
+        std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+        detail::UninitializedMoveN(longer.items_ + shorter.size_, longer.size_ - shorter.size_, shorter.end());
+        std::destroy_n(longer.items_ + shorter.size_, longer.size_ - shorter.size_);
+        std::swap(size_, other.size_);
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    static constexpr size_t Capacity() noexcept {
+        return N;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        return const_cast<StaticVector&>(*this)[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return items_[index];
+    }
+
+private:
+    static constexpr void CheckCapacity(size_t size) {
+        if (size > N) {
+            throw std::length_error("StaticVector capacity exceeded");
+        }
+    }
+
+    // Заменяет содержимое count элементами из from, переиспользуя уже созданные элементы
+    template <typename InputIt>
+    constexpr void Assign(InputIt from, size_t count) {
+        const size_t common = std::min<size_t>(size_, count);
+        std::copy_n(from, common, items_);
+        if (count < size_) {
+            std::destroy_n(items_ + count, size_ - count);
+        }
+        else {
+            for (size_t i = common; i < count; ++i) {
+                std::construct_at(items_ + i, *(from + i));
+            }
+        }
+        size_ = static_cast<SizeType>(count);
+    }
+
+    // Элементы создаются по мере вставки, поэтому массив лежит в безымянном объединении
+    union {
+        T items_[N];
+    };
+    SizeType size_ = 0;
+};
+
+// Наибольший размер встроенного буфера, при котором BoundedVector ещё выбирает StaticVector.
+// Большие буферы раздувают объекты и стек, и выигрыш от отсутствия выделения памяти теряется
+inline constexpr size_t STATIC_VECTOR_MAX_BYTES = 1024;
+
+// Вектор, размер которого заведомо не превышает Bound: StaticVector, если такой буфер помещается
+// в STATIC_VECTOR_MAX_BYTES, иначе Vector. Оба типа имеют одинаковый интерфейс
+template <typename T, size_t Bound>
+using BoundedVector = std::conditional_t<(Bound > 0 && Bound <= STATIC_VECTOR_MAX_BYTES / sizeof(T)),
+                                         StaticVector<T, Bound>, Vector<T>>;
+
+// Создаёт пустой BoundedVector<T, Bound>, которому больше не понадобятся выделения памяти
+template <typename T, size_t Bound>
+constexpr BoundedVector<T, Bound> MakeBoundedVector() {
+    BoundedVector<T, Bound> v;
+    v.Reserve(Bound);
+    return v;
+}
\ No newline at end of file
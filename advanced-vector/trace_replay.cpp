@@ -0,0 +1,201 @@
+#include "benchmark.h"
+#include "container_ops.h"
+#include "vector.h"
+#include "vector_trace.h"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Воспроизводит трассу, записанную VectorTracer, на Vector и std::vector и сравнивает пропускную способность:
+//     trace_replay <файл трассы> [--element-size=N] [параметры бенчмарка]
+
+namespace {
+
+    using namespace bench::ops;
+
+    // Элемент заданного размера: трасса хранит только sizeof(T), но не сам тип
+    template <size_t N>
+    struct Blob {
+        std::array<unsigned char, N> bytes{};
+    };
+
+    // Трасса с идентификаторами векторов, перенумерованными подряд с нуля
+    struct Replay {
+        std::vector<TraceRecord> records;
+        size_t vectors = 0;
+        // Самый частый sizeof(T) среди созданных векторов
+        size_t element_size = 0;
+    };
+
+    bool RefersToVector(TraceOp op) noexcept {
+        return op == TraceOp::COPY || op == TraceOp::MOVE || op == TraceOp::SWAP;
+    }
+
+    Replay Prepare(std::vector<TraceRecord> records) {
+        Replay replay;
+        std::unordered_map<uint64_t, uint32_t> ids;
+        std::map<uint64_t, size_t> element_sizes;
+        const auto dense_id = [&ids](uint64_t id) {
+            return ids.emplace(id, static_cast<uint32_t>(ids.size())).first->second;
+        };
+        for (TraceRecord& record : records) {
+            record.vector_id = dense_id(record.vector_id);
+            if (RefersToVector(record.op)) {
+                record.arg = dense_id(record.arg);
+            }
+            if (record.op == TraceOp::CREATE) {
+                ++element_sizes[record.arg];
+            }
+        }
+        replay.vectors = ids.size();
+        replay.records = std::move(records);
+        if (!element_sizes.empty()) {
+            replay.element_size = std::max_element(element_sizes.begin(), element_sizes.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.second < rhs.second;
+            })->first;
+        }
+        return replay;
+    }
+
+    template <typename Container, typename T>
+    void ReplayOnce(const Replay& replay) {
+        std::vector<std::unique_ptr<Container>> vectors(replay.vectors);
+        const auto get = [&vectors](size_t id) -> Container& {
+            if (!vectors[id]) {
+                // Начало жизни вектора могло не попасть в кольцо трассы
+                vectors[id] = std::make_unique<Container>();
+            }
+            return *vectors[id];
+        };
+        const T value{};
+        for (const TraceRecord& record : replay.records) {
+            if (record.op == TraceOp::DESTROY) {
+                vectors[record.vector_id].reset();
+                continue;
+            }
+            Container& v = get(record.vector_id);
+            const size_t size = Size(v);
+            switch (record.op) {
+            case TraceOp::CREATE:
+            case TraceOp::DESTROY:
+                break;
+            case TraceOp::PUSH_BACK:
+                PushBack(v, value);
+                break;
+            case TraceOp::EMPLACE:
+                EmplaceAt(v, std::min<size_t>(record.arg, size), value);
+                break;
+            case TraceOp::ERASE:
+                if (size != 0) {
+                    EraseAt(v, std::min<size_t>(record.arg, size - 1));
+                }
+                break;
+            case TraceOp::POP_BACK:
+                if (size != 0) {
+                    PopBack(v);
+                }
+                break;
+            case TraceOp::RESERVE:
+                Reserve(v, record.arg);
+                break;
+            case TraceOp::RESIZE:
+                Resize(v, record.arg);
+                break;
+            case TraceOp::COPY:
+                v = get(record.arg);
+                break;
+            case TraceOp::MOVE:
+                v = std::move(get(record.arg));
+                break;
+            case TraceOp::SWAP:
+                Swap(v, get(record.arg));
+                break;
+            }
+        }
+        bench::DoNotOptimize(vectors);
+    }
+
+    template <typename Container, typename T>
+    bench::Function ReplayCase(const Replay& replay) {
+        return [&replay](bench::State& state) {
+            while (state.KeepRunning()) {
+                ReplayOnce<Container, T>(replay);
+            }
+            state.SetItemsProcessed(replay.records.size());
+        };
+    }
+
+    template <size_t N>
+    void Run(const Replay& replay, const bench::Options& options) {
+        using T = Blob<N>;
+        const bench::Reporter reporter(std::cout);
+        reporter.PrintContext(options);
+        reporter.PrintHeader();
+        const std::string name = "Replay<Blob<" + std::to_string(N) + ">>";
+        const auto subject = bench::Measure(ReplayCase<Vector<T>, T>(replay), 0, options);
+        const auto baseline = bench::Measure(ReplayCase<std::vector<T>, T>(replay), 0, options);
+        reporter.PrintRow(name, "Vector", subject, baseline.median_ns > 0 ? subject.median_ns / baseline.median_ns : 0);
+        reporter.PrintRow("", "std::vector", baseline);
+    }
+
+    // Округляет размер элемента вверх до ближайшего поддерживаемого
+    void Dispatch(size_t element_size, const Replay& replay, const bench::Options& options) {
+        if (element_size <= 4) {
+            Run<4>(replay, options);
+        }
+        else if (element_size <= 8) {
+            Run<8>(replay, options);
+        }
+        else if (element_size <= 16) {
+            Run<16>(replay, options);
+        }
+        else if (element_size <= 32) {
+            Run<32>(replay, options);
+        }
+        else if (element_size <= 64) {
+            Run<64>(replay, options);
+        }
+        else {
+            Run<128>(replay, options);
+        }
+    }
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    using namespace std::literals;
+    try {
+        if (argc < 2) {
+            std::cerr << "Usage: "sv << argv[0] << " <trace file> [--element-size=N] [benchmark options]"sv << std::endl;
+            return 1;
+        }
+        size_t element_size = 0;
+        std::vector<char*> bench_args = {argv[0]};
+        for (int i = 2; i < argc; ++i) {
+            const std::string_view arg = argv[i];
+            if (arg.substr(0, "--element-size="sv.size()) == "--element-size="sv) {
+                element_size = std::stoull(std::string(arg.substr("--element-size="sv.size())));
+            }
+            else {
+                bench_args.push_back(argv[i]);
+            }
+        }
+        const bench::Options options = bench::ParseOptions(static_cast<int>(bench_args.size()), bench_args.data());
+        const Replay replay = Prepare(ReadTrace(argv[1]));
+        std::cout << "Trace: "sv << replay.records.size() << " records, "sv << replay.vectors << " vectors, element size "sv
+                  << replay.element_size << std::endl;
+        Dispatch(element_size != 0 ? element_size : replay.element_size, replay, options);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
\ No newline at end of file
@@ -1,343 +1,752 @@
-#pragma once
-#include <cassert>
-#include <cstdlib>
-#include <new>
-#include <utility>
-#include <memory>
-#include <algorithm>
-
-template <typename T>
-class RawMemory {
-public:
-    RawMemory() = default;
-
-    explicit RawMemory(size_t capacity)
-        : buffer_(Allocate(capacity))
-        , capacity_(capacity) {
-    }
-
-    ~RawMemory() {
-        Deallocate(buffer_);
-    }
-
-    RawMemory(const RawMemory&) = delete;
-    RawMemory& operator=(const RawMemory& rhs) = delete;
-    RawMemory(RawMemory&& other) noexcept {
-        this->buffer_ = std::move(other.buffer_);
-        this->capacity_ = std::move(other.capacity_);
-    }
-    RawMemory& operator=(RawMemory&& rhs) noexcept {
-        this->buffer_ = std::move(rhs.buffer_);
-        this->capacity_ = std::move(rhs.capacity_);
-        return *this;
-    }
-
-    T* operator+(size_t offset) noexcept {
-        //     ,     
-        assert(offset <= capacity_);
-        return buffer_ + offset;
-    }
-
-    const T* operator+(size_t offset) const noexcept {
-        return const_cast<RawMemory&>(*this) + offset;
-    }
-
-    const T& operator[](size_t index) const noexcept {
-        return const_cast<RawMemory&>(*this)[index];
-    }
-
-    T& operator[](size_t index) noexcept {
-        assert(index < capacity_);
-        return buffer_[index];
-    }
-
-    void Swap(RawMemory& other) noexcept {
-        std::swap(buffer_, other.buffer_);
-        std::swap(capacity_, other.capacity_);
-    }
-
-    const T* GetAddress() const noexcept {
-        return buffer_;
-    }
-
-    T* GetAddress() noexcept {
-        return buffer_;
-    }
-
-    size_t Capacity() const {
-        return capacity_;
-    }
-
-private:
-    //     n      
-    static T* Allocate(size_t n) {
-        return n != 0 ? static_cast<T*>(operator new(n * sizeof(T))) : nullptr;
-    }
-
-    //   ,     buf   Allocate
-    static void Deallocate(T* buf) noexcept {
-        operator delete(buf);
-    }
-
-    T* buffer_ = nullptr;
-    size_t capacity_ = 0;
-};
-
-template <typename T>
-class Vector {
-public:
-    using iterator = T*;
-    using const_iterator = const T*;
-
-    Vector() = default;
-
-    explicit Vector(size_t size)
-        : data_(size), size_(size)
-    {
-        std::uninitialized_value_construct_n(data_.GetAddress(), size);
-    }
-
-    Vector(const Vector& other)
-        : data_(other.size_), size_(other.size_)
-    {
-        std::uninitialized_copy_n(other.data_.GetAddress(), size_, data_.GetAddress());
-    }
-
-    Vector(Vector&& other) noexcept
-        :data_(std::move(other.data_)), size_(std::move(other.size_))
-    {
-        other.data_ = RawMemory<T>();
-        other.size_ = 0;
-    }
-
-    ~Vector() {
-        std::destroy_n(data_.GetAddress(), size_);
-    }
-
-    iterator begin() noexcept {
-        return data_.GetAddress();
-    }
-    iterator end() noexcept {
-        return data_ + size_;
-    }
-    const_iterator begin() const noexcept {
-        return data_.GetAddress();
-    }
-    const_iterator end() const noexcept {
-        return data_ + size_;
-    }
-    const_iterator cbegin() const noexcept {
-        return data_.GetAddress();
-    }
-    const_iterator cend() const noexcept {
-        return data_ + size_;
-    }
-
-    Vector& operator=(const Vector& rhs) {
-        if (this != &rhs) {
-            if (rhs.Capacity() > data_.Capacity()) {
-                Vector rhs_copy(rhs);
-                Swap(rhs_copy);
-            }
-            else {
-                if (this->size_ > rhs.size_) {
-                    auto it = std::copy_n(rhs.data_.GetAddress(), rhs.Size(), this->data_.GetAddress());
-                    std::destroy_n(it, this->size_ - rhs.Size());
-                    size_ = rhs.Size();
-                }
-                else {
-                    auto it = std::copy_n(rhs.data_.GetAddress(), this->size_, this->data_.GetAddress());
-                    auto rhs_it = rhs.data_.GetAddress() + this->size_;
-                    std::uninitialized_copy_n(rhs_it, rhs.Size() - this->size_, it);
-                    size_ = rhs.Size();
-                }
-            }
-        }
-        return *this;
-    }
-    Vector& operator=(Vector&& rhs) noexcept {
-        this->data_ = std::move(rhs.data_);
-        this->size_ = rhs.size_;
-        rhs.data_ = RawMemory<T>();
-        rhs.size_ = 0;
-        return *this;
-    }
-
-    void Reserve(size_t new_capacity) {
-        if (new_capacity <= data_.Capacity()) {
-            return;
-        }
-
-        RawMemory<T> new_data(new_capacity);
-        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-            std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-        }
-        else {
-            std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-        }
-
-        std::destroy_n(data_.GetAddress(), size_);
-        data_.Swap(new_data);
-    }
-
-    void Resize(size_t new_size) {
-        if (new_size == size_) {
-            return;
-        }
-
-        if (new_size < size_) {
-            auto it = data_.GetAddress() + new_size;
-            std::destroy_n(it, size_ - new_size);
-            size_ = new_size;
-        }
-        else {
-            Reserve(new_size);
-            auto it = data_.GetAddress() + size_;
-            std::uninitialized_value_construct_n(it, new_size - size_);
-            size_ = new_size;
-        }
-    }
-
-    void PushBack(const T& value) {
-        if (size_ == Capacity()) {
-            RawMemory<T> new_data((size_ == 0) ? 1 : (size_ * 2));
-            new (new_data + size_) T(value);
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            std::destroy_n(data_.GetAddress(), size_);
-            data_ = std::move(new_data);
-            new_data = RawMemory<T>();
-            ++size_;
-        }
-        else {
-            new (data_ + size_) T(value);
-            ++size_;
-        }
-    }
-    void PushBack(T&& value) {
-        if (size_ == Capacity()) {
-            RawMemory<T> new_data((size_ == 0) ? 1 : (size_ * 2));
-            new (new_data + size_) T(std::move(value));
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            std::destroy_n(data_.GetAddress(), size_);
-            data_ = std::move(new_data);
-            new_data = RawMemory<T>();
-            ++size_;
-        }
-        else {
-            new (data_ + size_) T(std::move(value));
-            ++size_;
-        }
-    }
-
-    template <typename... Args>
-    T& EmplaceBack(Args&&... args) {
-        if (size_ == Capacity()) {
-            RawMemory<T> new_data((size_ == 0) ? 1 : (size_ * 2));
-            auto elem = new (new_data + size_) T(std::forward<Args>(args)...);
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            else {
-                std::uninitialized_copy_n(data_.GetAddress(), size_, new_data.GetAddress());
-            }
-            std::destroy_n(data_.GetAddress(), size_);
-            data_ = std::move(new_data);
-            new_data = RawMemory<T>();
-            ++size_;
-            return *elem;
-        }
-        else {
-            auto elem = new (data_ + size_) T(std::forward<Args>(args)...);
-            ++size_;
-            return *elem;
-        }
-    }
-
-    template <typename... Args>
-    iterator Emplace(const_iterator pos, Args&&... args) {
-        size_t index = pos - begin();
-        if (size_ == index)
-        {
-            EmplaceBack(std::forward<Args>(args)...);
-        }
-        else if (size_ == Capacity()) {
-            RawMemory<T> new_data((size_ == 0) ? 1 : (size_ * 2));
-            new (new_data + index) T(std::forward<Args>(args)...);
-            if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
-                std::uninitialized_move_n(data_.GetAddress(), index, new_data.GetAddress());
-                std::uninitialized_move_n(data_ + index, size_ - index, new_data + (index + 1));
-            }
-            else {
-                std::uninitialized_copy_n(data_.GetAddress(), index, new_data.GetAddress());
-                std::uninitialized_copy_n(data_ + index, size_ - index, new_data + (index + 1));
-            }
-            std::destroy_n(data_.GetAddress(), size_);
-            data_ = std::move(new_data);
-            new_data = RawMemory<T>();
-            ++size_;
-        }
-        else {
-            T elem(std::forward<Args>(args)...);
-            new (data_ + size_) T(std::move(*(data_ + (size_ - 1))));
-            std::move_backward(data_.GetAddress() + index, data_.GetAddress() + (size_ - 1), data_.GetAddress() + size_);
-            data_[index] = std::move(elem);
-            ++size_;
-        }
-        return data_ + index;
-    }
-    iterator Insert(const_iterator pos, const T& value) {
-        return Emplace(pos, value);
-    }
-    iterator Insert(const_iterator pos, T&& value) {
-        return Emplace(pos, std::move(value));
-    }
-
-    iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
-        size_t index = pos - begin();
-        std::move(data_ + (index + 1), data_ + size_, data_ + index);
-        std::destroy_at(data_ + (size_ - 1));
-        --size_;
-        return data_ + index;
-    }
-
-    void PopBack() noexcept {
-        std::destroy_at(data_ + (size_ - 1));
-        --size_;
-    }
-
-    void Swap(Vector& other) noexcept {
-        this->data_.Swap(other.data_);
-        std::swap(this->size_, other.size_);
-    }
-
-    size_t Size() const noexcept {
-        return size_;
-    }
-
-    size_t Capacity() const noexcept {
-        return data_.Capacity();
-    }
-
-    const T& operator[](size_t index) const noexcept {
-        return const_cast<Vector&>(*this)[index];
-    }
-
-    T& operator[](size_t index) noexcept {
-        assert(index < size_);
-        return data_[index];
-    }
-
-private:
-    RawMemory<T> data_;
-    size_t size_ = 0;
-};
\ No newline at end of file
+#pragma once
+#include "allocation_stats.h"
+#include "hash_bytes.h"
+#include "vector_trace.h"
+#ifdef ADVANCED_VECTOR_TRACK_CAPACITY
+#include "capacity_report.h"
+#endif
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <utility>
+#include <memory>
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <type_traits>
+
+// Vector и RawMemory пригодны для вычислений на этапе компиляции (C++20): память выделяется через
+// std::allocator, элементы создаются std::construct_at. Учёт выделений памяти во время таких вычислений
+// не ведётся, а сборка с ADVANCED_VECTOR_TRACK_CAPACITY или ADVANCED_VECTOR_TRACE делает их невозможными
+
+// Сообщает компилятору, что итерации следующего цикла независимы и его можно векторизовать
+// без проверки пересечения массивов во время выполнения
+#if defined(__clang__)
+#define ADVANCED_VECTOR_IVDEP _Pragma("clang loop vectorize(assume_safety)")
+#elif defined(__GNUC__)
+#define ADVANCED_VECTOR_IVDEP _Pragma("GCC ivdep")
+#else
+#define ADVANCED_VECTOR_IVDEP
+#endif
+
+namespace detail {
+
+    // Аналоги std::uninitialized_*_n, которые станут constexpr только в C++26
+    template <typename T>
+    constexpr T* UninitializedValueConstructN(T* first, size_t count) {
+        if (std::is_constant_evaluated()) {
+            for (; count > 0; --count, ++first) {
+                std::construct_at(first);
+            }
+            return first;
+        }
+        return std::uninitialized_value_construct_n(first, count);
+    }
+
+    template <typename T>
+    constexpr T* UninitializedCopyN(const T* from, size_t count, T* to) {
+        if (std::is_constant_evaluated()) {
+            for (; count > 0; --count, ++from, ++to) {
+                std::construct_at(to, *from);
+            }
+            return to;
+        }
+        return std::uninitialized_copy_n(from, count, to);
+    }
+
+    // Аналог std::uninitialized_fill_n. Для тривиально копируемых T значение, все байты которого равны,
+    // пишется memset, а иначе копируется блоками около 256 байт из повторений value: memcpy постоянной
+    // длины компилятор разворачивает в векторные записи, а поэлементный цикл при -O2 не векторизует.
+    // Длина блока кратна строке кэша, чтобы записи блоков не делили строки
+    template <typename T>
+    constexpr T* UninitializedFillN(T* first, size_t count, const T& value) {
+        if (std::is_constant_evaluated()) {
+            for (; count > 0; --count, ++first) {
+                std::construct_at(first, value);
+            }
+            return first;
+        }
+        if constexpr (std::is_trivially_copyable_v<T> && sizeof(T) <= 64) {
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, std::addressof(value), sizeof(T));
+            if (std::all_of(bytes, bytes + sizeof(T), [&bytes](unsigned char byte) {
+                    return byte == bytes[0];
+                })) {
+                std::memset(static_cast<void*>(first), bytes[0], count * sizeof(T));
+                return first + count;
+            }
+            constexpr size_t LINE = 64 / std::gcd(sizeof(T), size_t(64));
+            constexpr size_t BLOCK = LINE * std::max<size_t>(256 / (LINE * sizeof(T)), 1);
+            if (count >= BLOCK) {
+                unsigned char block[BLOCK * sizeof(T)];
+                for (size_t i = 0; i < BLOCK; ++i) {
+                    std::memcpy(block + i * sizeof(T), bytes, sizeof(T));
+                }
+                auto* out = reinterpret_cast<unsigned char*>(first);
+                size_t i = 0;
+                for (; i + BLOCK <= count; i += BLOCK) {
+                    std::memcpy(out + i * sizeof(T), block, sizeof(block));
+                }
+                std::memcpy(out + i * sizeof(T), block, (count - i) * sizeof(T));
+                return first + count;
+            }
+        }
+        return std::uninitialized_fill_n(first, count, value);
+    }
+
+    template <typename T>
+    constexpr T* UninitializedMoveN(T* from, size_t count, T* to) {
+        if (std::is_constant_evaluated()) {
+            for (; count > 0; --count, ++from, ++to) {
+                std::construct_at(to, std::move(*from));
+            }
+            return to;
+        }
+        return std::uninitialized_move_n(from, count, to).second;
+    }
+
+    // Вызывает f(i) для всех i из [from, to). Основная часть обходится блоками постоянной длины:
+    // такие циклы GCC векторизует уже при -O2, а циклы переменной длины — только при -O3
+    template <typename F>
+    constexpr void ForEachIndex(size_t from, size_t to, F f) {
+        constexpr size_t BLOCK = 16;
+        size_t i = from;
+        for (; i + BLOCK <= to; i += BLOCK) {
+            ADVANCED_VECTOR_IVDEP
+            for (size_t j = 0; j < BLOCK; ++j) {
+                f(i + j);
+            }
+        }
+        for (; i < to; ++i) {
+            f(i);
+        }
+    }
+
+}  // namespace detail
+
+// Ленивое поэлементное выражение (см. numeric.h), которое вычисляется при присваивании вектору.
+// У него есть Size() и operator[], возвращающий значение, приводимое к T
+template <typename E>
+struct IsVectorExpression : std::false_type {};
+
+// Равенство элементов совпадает с равенством их байтов: тогда векторы сравниваются через memcmp,
+// а хешируются за один проход по всему буферу. Для структур без заполнителей с поэлементным ==
+// признак можно включить специализацией
+template <typename T>
+struct IsBitwiseComparable : std::bool_constant<std::is_integral_v<T> || std::is_enum_v<T> || std::is_pointer_v<T>> {};
+
+template <typename T>
+class RawMemory {
+public:
+    // Политика учёта выделений памяти, см. allocation_stats.h
+    using Tracking = AllocationPolicyFor<T>;
+
+    constexpr RawMemory() = default;
+
+    constexpr explicit RawMemory(size_t capacity)
+        : buffer_(Allocate(capacity))
+        , capacity_(capacity) {
+    }
+
+    constexpr ~RawMemory() {
+        Deallocate(buffer_, capacity_);
+    }
+
+    RawMemory(const RawMemory&) = delete;
+    RawMemory& operator=(const RawMemory& rhs) = delete;
+    constexpr RawMemory(RawMemory&& other) noexcept
+        : buffer_(std::exchange(other.buffer_, nullptr))
+        , capacity_(std::exchange(other.capacity_, 0)) {
+    }
+    constexpr RawMemory& operator=(RawMemory&& rhs) noexcept {
+        if (this != &rhs) {
+            RawMemory tmp(std::move(rhs));
+            Swap(tmp);
+        }
+        return *this;
+    }
+
+    constexpr T* operator+(size_t offset) noexcept {
+        // Разрешается получать адрес ячейки памяти, следующей за последним элементом массива
+        assert(offset <= capacity_);
+        return buffer_ + offset;
+    }
+
+    constexpr const T* operator+(size_t offset) const noexcept {
+        return const_cast<RawMemory&>(*this) + offset;
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        return const_cast<RawMemory&>(*this)[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < capacity_);
+        return buffer_[index];
+    }
+
+    constexpr void Swap(RawMemory& other) noexcept {
+        std::swap(buffer_, other.buffer_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    constexpr const T* GetAddress() const noexcept {
+        return buffer_;
+    }
+
+    constexpr T* GetAddress() noexcept {
+        return buffer_;
+    }
+
+    constexpr size_t Capacity() const {
+        return capacity_;
+    }
+
+private:
+    // Выделяет сырую память под n элементов и возвращает указатель на неё
+    static constexpr T* Allocate(size_t n) {
+        if (n == 0) {
+            return nullptr;
+        }
+        T* buf = std::allocator<T>().allocate(n);
+        if (!std::is_constant_evaluated()) {
+            Tracking::OnAllocate(n * sizeof(T));
+        }
+        return buf;
+    }
+
+    // Освобождает сырую память, выделенную ранее по адресу buf при помощи Allocate
+    static constexpr void Deallocate(T* buf, size_t n) noexcept {
+        if (buf == nullptr) {
+            return;
+        }
+        if (!std::is_constant_evaluated()) {
+            Tracking::OnDeallocate(n * sizeof(T));
+        }
+        std::allocator<T>().deallocate(buf, n);
+    }
+
+    T* buffer_ = nullptr;
+    size_t capacity_ = 0;
+};
+
+template <typename T>
+class Vector {
+public:
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    constexpr Vector() = default;
+
+    constexpr explicit Vector(size_t size)
+        : data_(size), size_(size)
+    {
+        detail::UninitializedValueConstructN(data_.GetAddress(), size);
+        Trace(TraceOp::RESIZE, size);
+    }
+
+    constexpr Vector(size_t size, const T& value)
+        : data_(size), size_(size)
+    {
+        detail::UninitializedFillN(data_.GetAddress(), size, value);
+        Trace(TraceOp::RESIZE, size);
+    }
+
+    constexpr Vector(const Vector& other)
+        : data_(other.size_), size_(other.size_)
+    {
+        detail::UninitializedCopyN(other.data_.GetAddress(), size_, data_.GetAddress());
+        Trace(TraceOp::COPY, TraceId(other));
+    }
+
+    constexpr Vector(Vector&& other) noexcept
+        :data_(std::move(other.data_)), size_(std::exchange(other.size_, 0))
+    {
+        Trace(TraceOp::MOVE, TraceId(other));
+    }
+
+    template <typename E, std::enable_if_t<IsVectorExpression<E>::value, int> = 0>
+    constexpr Vector(const E& expression) {
+        AssignExpression(expression);
+    }
+
+    constexpr ~Vector() {
+        std::destroy_n(data_.GetAddress(), size_);
+    }
+
+    // Создают вектор из элементов массива за одно выделение памяти ровно под N элементов
+    template <size_t N>
+    static constexpr Vector FromArray(const T (&items)[N]) {
+        return FromElements(items, N, detail::UninitializedCopyN<T>);
+    }
+    template <size_t N>
+    static constexpr Vector FromArray(const std::array<T, N>& items) {
+        return FromElements(items.data(), N, detail::UninitializedCopyN<T>);
+    }
+    template <size_t N>
+    static constexpr Vector FromArray(std::array<T, N>&& items) {
+        return FromElements(items.data(), N, detail::UninitializedMoveN<T>);
+    }
+
+    constexpr iterator begin() noexcept {
+        return data_.GetAddress();
+    }
+    constexpr iterator end() noexcept {
+        return data_ + size_;
+    }
+    constexpr const_iterator begin() const noexcept {
+        return data_.GetAddress();
+    }
+    constexpr const_iterator end() const noexcept {
+        return data_ + size_;
+    }
+    constexpr const_iterator cbegin() const noexcept {
+        return data_.GetAddress();
+    }
+    constexpr const_iterator cend() const noexcept {
+        return data_ + size_;
+    }
+
+    constexpr Vector& operator=(const Vector& rhs) {
+        if (this != &rhs) {
+            Trace(TraceOp::COPY, TraceId(rhs));
+            if (rhs.Capacity() > data_.Capacity()) {
+                // Без временного Vector: его создание, копирование и обмен попали бы в трассу отдельными
+                // операциями, и при воспроизведении копирование выполнилось бы дважды
+                RawMemory<T> new_data(rhs.size_);
+                detail::UninitializedCopyN(rhs.data_.GetAddress(), rhs.size_, new_data.GetAddress());
+                std::destroy_n(data_.GetAddress(), size_);
+                data_.Swap(new_data);
+                size_ = rhs.size_;
+            }
+            else {
+                if (this->size_ > rhs.size_) {
+                    auto it = std::copy_n(rhs.data_.GetAddress(), rhs.Size(), this->data_.GetAddress());
+                    std::destroy_n(it, this->size_ - rhs.Size());
+                    size_ = rhs.Size();
+                }
+                else {
+                    auto it = std::copy_n(rhs.data_.GetAddress(), this->size_, this->data_.GetAddress());
+                    auto rhs_it = rhs.data_.GetAddress() + this->size_;
+                    detail::UninitializedCopyN(rhs_it, rhs.Size() - this->size_, it);
+                    size_ = rhs.Size();
+                }
+            }
+        }
+        return *this;
+    }
+    constexpr Vector& operator=(Vector&& rhs) noexcept {
+        if (this != &rhs) {
+            Trace(TraceOp::MOVE, TraceId(rhs));
+            std::destroy_n(data_.GetAddress(), size_);
+            this->data_ = std::move(rhs.data_);
+            this->size_ = std::exchange(rhs.size_, 0);
+        }
+        return *this;
+    }
+
+    // Вычисляет выражение одним проходом прямо в элементы вектора. Выражение может ссылаться
+    // на сам вектор (v = v * 2): каждый элемент результата зависит только от элементов операндов
+    // в той же позиции, поэтому цикл векторизуется без проверок пересечения
+    template <typename E, std::enable_if_t<IsVectorExpression<E>::value, int> = 0>
+    constexpr Vector& operator=(const E& expression) {
+        AssignExpression(expression);
+        return *this;
+    }
+
+    constexpr void Reserve(size_t new_capacity) {
+        Trace(TraceOp::RESERVE, new_capacity);
+        if (new_capacity <= data_.Capacity()) {
+            return;
+        }
+
+        RawMemory<T> new_data(new_capacity);
+        Relocate(data_.GetAddress(), size_, new_data.GetAddress());
+        ReplaceData(new_data);
+    }
+
+    constexpr void Resize(size_t new_size) {
+        Trace(TraceOp::RESIZE, new_size);
+        if (new_size == size_) {
+            return;
+        }
+
+        if (new_size < size_) {
+            auto it = data_.GetAddress() + new_size;
+            std::destroy_n(it, size_ - new_size);
+            size_ = new_size;
+        }
+        else {
+            Reserve(new_size);
+            auto it = data_.GetAddress() + size_;
+            detail::UninitializedValueConstructN(it, new_size - size_);
+            size_ = new_size;
+        }
+    }
+
+    // Как Resize(new_size), но новые элементы — копии value. value может быть элементом самого вектора
+    constexpr void Resize(size_t new_size, const T& value) {
+        Trace(TraceOp::RESIZE, new_size);
+        if (new_size <= size_) {
+            std::destroy_n(data_.GetAddress() + new_size, size_ - new_size);
+            size_ = new_size;
+        }
+        else if (new_size > data_.Capacity()) {
+            // Новые элементы создаются до переноса старых, пока value ещё жив
+            RawMemory<T> new_data(new_size);
+            detail::UninitializedFillN(new_data + size_, new_size - size_, value);
+            Relocate(data_.GetAddress(), size_, new_data.GetAddress());
+            ReplaceData(new_data);
+            size_ = new_size;
+        }
+        else {
+            detail::UninitializedFillN(data_ + size_, new_size - size_, value);
+            size_ = new_size;
+        }
+    }
+
+    // Заменяет содержимое count копиями value. value может быть элементом самого вектора
+    constexpr void Assign(size_t count, const T& value) {
+        Trace(TraceOp::RESIZE, count);
+        if (count > data_.Capacity()) {
+            RawMemory<T> new_data(count);
+            detail::UninitializedFillN(new_data.GetAddress(), count, value);
+            std::destroy_n(data_.GetAddress(), size_);
+            size_ = 0;
+            ReplaceData(new_data);
+            size_ = count;
+        }
+        else if (std::is_trivially_copyable_v<T> && !std::is_constant_evaluated()) {
+            // Старые элементы уничтожать не нужно, а перезапись одним заполнением быстрее присваиваний
+            detail::UninitializedFillN(data_.GetAddress(), count, value);
+            size_ = count;
+        }
+        else {
+            std::fill_n(data_.GetAddress(), std::min(count, size_), value);
+            if (count > size_) {
+                detail::UninitializedFillN(data_ + size_, count - size_, value);
+            }
+            else {
+                std::destroy_n(data_ + count, size_ - count);
+            }
+            size_ = count;
+        }
+    }
+
+    // Увеличивает размер на count, не инициализируя новые элементы, и возвращает указатель на первый из них.
+    // Только для тривиально копируемых T: вызывающий сам заполняет элементы побайтно, например параллельным
+    // копированием, и конструкторы по умолчанию (в том числе инициализаторы членов) не вызываются.
+    // Ёмкость растёт не меньше чем вдвое, как в EmplaceBack
+    constexpr T* ExtendUninitialized(size_t count) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+                      "ExtendUninitialized requires a trivially copyable element type");
+        Trace(TraceOp::RESIZE, size_ + count);
+        if (size_ + count > data_.Capacity()) {
+            Reserve(std::max(size_ + count, size_ * 2));
+        }
+        T* first = data_ + size_;
+        size_ += count;
+        return first;
+    }
+
+    // Уничтожает все элементы, сохраняя ёмкость
+    constexpr void Clear() noexcept {
+        Trace(TraceOp::RESIZE, 0);
+        std::destroy_n(data_.GetAddress(), size_);
+        size_ = 0;
+    }
+
+    constexpr void PushBack(const T& value) {
+        EmplaceBack(value);
+    }
+    constexpr void PushBack(T&& value) {
+        EmplaceBack(std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr T& EmplaceBack(Args&&... args) {
+        Trace(TraceOp::PUSH_BACK, size_);
+        if (size_ == Capacity()) {
+            RawMemory<T> new_data((size_ == 0) ? 1 : (size_ * 2));
+            auto elem = std::construct_at(new_data + size_, std::forward<Args>(args)...);
+            Relocate(data_.GetAddress(), size_, new_data.GetAddress());
+            ReplaceData(new_data);
+            ++size_;
+            return *elem;
+        }
+        else {
+            auto elem = std::construct_at(data_ + size_, std::forward<Args>(args)...);
+            ++size_;
+            return *elem;
+        }
+    }
+
+    template <typename... Args>
+    constexpr iterator Emplace(const_iterator pos, Args&&... args) {
+        size_t index = pos - begin();
+        if (size_ == index)
+        {
+            EmplaceBack(std::forward<Args>(args)...);
+            return data_ + index;
+        }
+        Trace(TraceOp::EMPLACE, index);
+        if (size_ == Capacity()) {
+            RawMemory<T> new_data((size_ == 0) ? 1 : (size_ * 2));
+            std::construct_at(new_data + index, std::forward<Args>(args)...);
+            Relocate(data_.GetAddress(), index, new_data.GetAddress());
+            Relocate(data_ + index, size_ - index, new_data + (index + 1));
+            ReplaceData(new_data);
+            ++size_;
+        }
+        else {
+            T elem(std::forward<Args>(args)...);
+            std::construct_at(data_ + size_, std::move(*(data_ + (size_ - 1))));
+            std::move_backward(data_.GetAddress() + index, data_.GetAddress() + (size_ - 1), data_.GetAddress() + size_);
+            data_[index] = std::move(elem);
+            ++size_;
+        }
+        return data_ + index;
+    }
+    constexpr iterator Insert(const_iterator pos, const T& value) {
+        return Emplace(pos, value);
+    }
+    constexpr iterator Insert(const_iterator pos, T&& value) {
+        return Emplace(pos, std::move(value));
+    }
+
+    constexpr iterator Erase(const_iterator pos) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        size_t index = pos - begin();
+        Trace(TraceOp::ERASE, index);
+        std::move(data_ + (index + 1), data_ + size_, data_ + index);
+        std::destroy_at(data_ + (size_ - 1));
+        --size_;
+        return data_ + index;
+    }
+
+    constexpr void PopBack() noexcept {
+        Trace(TraceOp::POP_BACK);
+        std::destroy_at(data_ + (size_ - 1));
+        --size_;
+    }
+
+    constexpr void Swap(Vector& other) noexcept {
+        Trace(TraceOp::SWAP, TraceId(other));
+        this->data_.Swap(other.data_);
+        std::swap(this->size_, other.size_);
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    constexpr size_t Capacity() const noexcept {
+        return data_.Capacity();
+    }
+
+    constexpr const T& operator[](size_t index) const noexcept {
+        return const_cast<Vector&>(*this)[index];
+    }
+
+    constexpr T& operator[](size_t index) noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Хеш, согласованный с ==. Для побайтно сравнимых элементов — хеш всего буфера (см. hash_bytes.h),
+    // иначе — комбинация std::hash элементов
+    size_t Hash() const noexcept {
+        if constexpr (IsBitwiseComparable<T>::value) {
+            return static_cast<size_t>(detail::HashBytes(begin(), size_ * sizeof(T)));
+        }
+        else {
+            uint64_t hash = size_;
+            for (const T& item : *this) {
+                hash = detail::HashCombine(hash, std::hash<T>{}(item));
+            }
+            return static_cast<size_t>(hash);
+        }
+    }
+
+private:
+    template <typename From, typename Construct>
+    static constexpr Vector FromElements(From* items, size_t count, Construct construct) {
+        Vector v;
+        v.data_ = RawMemory<T>(count);
+        construct(items, count, v.data_.GetAddress());
+        v.size_ = count;
+        v.Trace(TraceOp::RESIZE, count);
+        return v;
+    }
+
+    template <typename E>
+    constexpr void AssignExpression(const E& expression) {
+        const size_t size = expression.Size();
+        Trace(TraceOp::RESIZE, size);
+        if (size > data_.Capacity()) {
+            // Старые элементы ещё нужны выражению, поэтому уничтожаются только после вычисления
+            RawMemory<T> new_data(size);
+            T* out = new_data.GetAddress();
+            detail::ForEachIndex(0, size, [out, &expression](size_t i) {
+                std::construct_at(out + i, expression[i]);
+            });
+            std::destroy_n(data_.GetAddress(), size_);
+            size_ = 0;
+            ReplaceData(new_data);
+            size_ = size;
+            return;
+        }
+        T* out = data_.GetAddress();
+        const size_t common = std::min(size, size_);
+        detail::ForEachIndex(0, common, [out, &expression](size_t i) {
+            out[i] = expression[i];
+        });
+        detail::ForEachIndex(common, size, [out, &expression](size_t i) {
+            std::construct_at(out + i, expression[i]);
+        });
+        if (size < size_) {
+            std::destroy_n(out + size, size_ - size);
+        }
+        size_ = size;
+    }
+
+    // Переносит count элементов в неинициализированную память to:
+    // перемещением, если оно не бросает исключений, иначе копированием
+    static constexpr void Relocate(T* from, size_t count, T* to) {
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            detail::UninitializedMoveN(from, count, to);
+        }
+        else {
+            detail::UninitializedCopyN(from, count, to);
+        }
+    }
+
+    // Уничтожает элементы в текущем буфере и переключается на new_data, куда они уже перенесены
+    constexpr void ReplaceData(RawMemory<T>& new_data) noexcept {
+        std::destroy_n(data_.GetAddress(), size_);
+        data_.Swap(new_data);
+        if (std::is_constant_evaluated()) {
+            return;
+        }
+        RawMemory<T>::Tracking::OnGrowth(size_);
+#ifdef ADVANCED_VECTOR_TRACK_CAPACITY
+        usage_hook_.OnGrowth(data_.Capacity());
+#endif
+    }
+
+    // Записывает операцию в трассу, если вектор собран с ADVANCED_VECTOR_TRACE, см. vector_trace.h
+    constexpr void Trace([[maybe_unused]] TraceOp op, [[maybe_unused]] uint64_t arg = 0) const noexcept {
+#ifdef ADVANCED_VECTOR_TRACE
+        if (!std::is_constant_evaluated()) {
+            trace_hook_.Record(op, arg);
+        }
+#endif
+    }
+
+    static constexpr uint64_t TraceId([[maybe_unused]] const Vector& vector) noexcept {
+#ifdef ADVANCED_VECTOR_TRACE
+        return vector.trace_hook_.Id();
+#else
+        return 0;
+#endif
+    }
+
+    RawMemory<T> data_;
+    size_t size_ = 0;
+#ifdef ADVANCED_VECTOR_TRACK_CAPACITY
+    // Регистрирует вектор в CapacityRegistry, см. capacity_report.h
+    VectorUsageHook usage_hook_{ *this };
+#endif
+#ifdef ADVANCED_VECTOR_TRACE
+    VectorTraceHook trace_hook_{ sizeof(T) };
+#endif
+};
+
+namespace detail {
+
+    // Индекс первого различающегося элемента среди первых size. Равные участки побайтно сравнимых
+    // элементов пропускаются блоками через memcmp, которая сравнивает по 32–64 байта за инструкцию
+    template <typename T>
+    constexpr size_t Mismatch(const T* lhs, const T* rhs, size_t size) noexcept {
+        size_t i = 0;
+        if constexpr (IsBitwiseComparable<T>::value) {
+            if (!std::is_constant_evaluated()) {
+                constexpr size_t BLOCK = std::max<size_t>(256 / sizeof(T), 1);
+                while (i + BLOCK <= size && std::memcmp(lhs + i, rhs + i, BLOCK * sizeof(T)) == 0) {
+                    i += BLOCK;
+                }
+            }
+        }
+        while (i < size && lhs[i] == rhs[i]) {
+            ++i;
+        }
+        return i;
+    }
+
+}  // namespace detail
+
+template <typename T>
+constexpr bool operator==(const Vector<T>& lhs, const Vector<T>& rhs) {
+    if (lhs.Size() != rhs.Size()) {
+        return false;
+    }
+    if constexpr (IsBitwiseComparable<T>::value) {
+        if (!std::is_constant_evaluated()) {
+            return lhs.Size() == 0 || std::memcmp(lhs.begin(), rhs.begin(), lhs.Size() * sizeof(T)) == 0;
+        }
+    }
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+// Лексикографическое сравнение. Побайтное сравнение не совпадает с порядком многобайтных чисел,
+// поэтому memcmp только находит первое различие, а порядок определяют различающиеся элементы
+template <typename T>
+constexpr bool operator<(const Vector<T>& lhs, const Vector<T>& rhs) {
+    const size_t common = std::min(lhs.Size(), rhs.Size());
+    const size_t i = detail::Mismatch(lhs.begin(), rhs.begin(), common);
+    return i == common ? lhs.Size() < rhs.Size() : lhs[i] < rhs[i];
+}
+
+template <typename T>
+constexpr bool operator>(const Vector<T>& lhs, const Vector<T>& rhs) {
+    return rhs < lhs;
+}
+
+template <typename T>
+constexpr bool operator<=(const Vector<T>& lhs, const Vector<T>& rhs) {
+    return !(rhs < lhs);
+}
+
+template <typename T>
+constexpr bool operator>=(const Vector<T>& lhs, const Vector<T>& rhs) {
+    return !(lhs < rhs);
+}
+
+template <typename T>
+struct std::hash<Vector<T>> {
+    size_t operator()(const Vector<T>& v) const noexcept {
+        return v.Hash();
+    }
+};
+
+// Вычисляет вектор на этапе компиляции и копирует его в std::array подходящего размера,
+// чтобы таблицы не строились при запуске программы:
+//     constexpr auto squares = ToStaticArray<[] {
+//         Vector<int> v;
+//         for (int i = 0; i < 10; ++i) {
+//             v.PushBack(i * i);
+//         }
+//         return v;
+//     }>();
+// Generator вызывается дважды: сначала для определения размера, затем для получения элементов
+template <auto Generator>
+consteval auto ToStaticArray() {
+    using T = std::remove_cvref_t<decltype(*Generator().begin())>;
+    constexpr size_t size = Generator().Size();
+    std::array<T, size> result{};
+    const auto v = Generator();
+    std::copy(v.begin(), v.end(), result.begin());
+    return result;
+}
\ No newline at end of file
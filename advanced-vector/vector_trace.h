@@ -0,0 +1,208 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Трассировка операций над векторами для воспроизведения нагрузки (см. trace_replay.cpp).
+// Векторы пишут трассу, только если собраны с макросом ADVANCED_VECTOR_TRACE,
+// и только между VectorTracer::Start и VectorTracer::Stop
+
+enum class TraceOp : uint8_t {
+    CREATE,       // arg — sizeof(T)
+    DESTROY,
+    PUSH_BACK,    // PushBack и EmplaceBack, arg — размер до вставки
+    EMPLACE,      // arg — позиция
+    ERASE,        // arg — позиция
+    POP_BACK,
+    RESERVE,      // arg — запрошенная ёмкость
+    RESIZE,       // arg — новый размер
+    COPY,         // копирование из вектора с идентификатором arg
+    MOVE,         // перемещение из вектора с идентификатором arg
+    SWAP,         // обмен с вектором с идентификатором arg
+};
+
+struct TraceRecord {
+    uint32_t vector_id = 0;
+    TraceOp op = TraceOp::CREATE;
+    uint8_t reserved[3] = {};
+    uint64_t arg = 0;
+};
+static_assert(sizeof(TraceRecord) == 16);
+
+// Заголовок файла трассы, за ним следуют записи в хронологическом порядке
+struct TraceFileHeader {
+    static constexpr char MAGIC[8] = {'A', 'V', 'T', 'R', 'A', 'C', 'E', '1'};
+
+    char magic[8] = {};
+    uint32_t record_size = sizeof(TraceRecord);
+    uint32_t reserved = 0;
+    // Сколько записей было сделано всего; в файле остаются последние min(written, capacity)
+    uint64_t written = 0;
+    uint64_t capacity = 0;
+};
+
+// Кольцевой буфер последних записей. Запись — несколько атомарных операций без блокировок и копирование
+// 16 байт, поэтому трассировку можно оставлять включённой под нагрузкой
+class VectorTracer {
+public:
+    static VectorTracer& Instance() {
+        static VectorTracer tracer;
+        return tracer;
+    }
+
+    VectorTracer(const VectorTracer&) = delete;
+    VectorTracer& operator=(const VectorTracer&) = delete;
+
+    ~VectorTracer() {
+        Stop();
+    }
+
+    // Начинает запись в кольцо на capacity записей, которое будет сохранено в path.
+    // Не должна вызываться, пока другие потоки работают с векторами
+    void Start(std::string path, size_t capacity = 1 << 20) {
+        if (capacity == 0) {
+            throw std::invalid_argument("Trace capacity must be positive");
+        }
+        std::lock_guard guard(mutex_);
+        path_ = std::move(path);
+        ring_ = std::make_unique<TraceRecord[]>(capacity);
+        capacity_ = capacity;
+        next_.store(0, std::memory_order_relaxed);
+        enabled_.store(true, std::memory_order_release);
+    }
+
+    // Прекращает запись и сохраняет трассу
+    bool Stop() {
+        std::lock_guard guard(mutex_);
+        if (!enabled_.exchange(false)) {
+            return true;
+        }
+        WaitForWriters();
+        return Save();
+    }
+
+    // Сохраняет текущее содержимое кольца и продолжает запись. Пока кольцо сохраняется,
+    // операции других потоков не записываются, иначе в файл попали бы записи, изменённые наполовину
+    bool Flush() {
+        std::lock_guard guard(mutex_);
+        const bool enabled = enabled_.exchange(false);
+        WaitForWriters();
+        const bool saved = Save();
+        enabled_.store(enabled, std::memory_order_release);
+        return saved;
+    }
+
+    bool IsEnabled() const noexcept {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    uint32_t NewVectorId() noexcept {
+        return next_id_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void Record(uint32_t vector_id, TraceOp op, uint64_t arg) noexcept {
+        if (!IsEnabled()) {
+            return;
+        }
+        // Счётчик писателей увеличивается до повторной проверки enabled_: Stop и Flush, выключив запись,
+        // ждут, пока он обнулится, и после этого кольцо никто не меняет
+        writers_.fetch_add(1);
+        if (enabled_.load()) {
+            const uint64_t slot = next_.fetch_add(1, std::memory_order_relaxed);
+            TraceRecord& record = ring_[slot % capacity_];
+            record.vector_id = vector_id;
+            record.op = op;
+            record.arg = arg;
+        }
+        writers_.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    VectorTracer() = default;
+
+    void WaitForWriters() const noexcept {
+        while (writers_.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Сохраняет кольцо; запись выключена, и писателей нет
+    bool Save() {
+        if (ring_ == nullptr) {
+            return false;
+        }
+        TraceFileHeader header;
+        std::memcpy(header.magic, TraceFileHeader::MAGIC, sizeof(header.magic));
+        header.written = next_.load(std::memory_order_acquire);
+        header.capacity = capacity_;
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        const uint64_t count = std::min<uint64_t>(header.written, capacity_);
+        for (uint64_t i = header.written - count; i < header.written; ++i) {
+            out.write(reinterpret_cast<const char*>(&ring_[i % capacity_]), sizeof(TraceRecord));
+        }
+        return static_cast<bool>(out);
+    }
+
+    std::mutex mutex_;
+    std::string path_;
+    std::unique_ptr<TraceRecord[]> ring_;
+    size_t capacity_ = 0;
+    std::atomic<bool> enabled_ = false;
+    std::atomic<uint64_t> next_ = 0;
+    // Сколько потоков сейчас в Record
+    std::atomic<uint32_t> writers_ = 0;
+    // Идентификатор 0 зарезервирован за векторами, созданными без трассировки
+    std::atomic<uint32_t> next_id_ = 1;
+};
+
+// Член Vector, назначающий ему идентификатор и отмечающий в трассе создание и уничтожение
+class VectorTraceHook {
+public:
+    explicit VectorTraceHook(size_t element_size) noexcept
+        : id_(VectorTracer::Instance().NewVectorId()) {
+        Record(TraceOp::CREATE, element_size);
+    }
+
+    VectorTraceHook(const VectorTraceHook&) = delete;
+    VectorTraceHook& operator=(const VectorTraceHook&) = delete;
+
+    ~VectorTraceHook() {
+        Record(TraceOp::DESTROY, 0);
+    }
+
+    uint32_t Id() const noexcept {
+        return id_;
+    }
+
+    void Record(TraceOp op, uint64_t arg) const noexcept {
+        VectorTracer::Instance().Record(id_, op, arg);
+    }
+
+private:
+    uint32_t id_;
+};
+
+// Читает трассу, сохранённую VectorTracer
+inline std::vector<TraceRecord> ReadTrace(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    TraceFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, TraceFileHeader::MAGIC, sizeof(header.magic)) != 0
+        || header.record_size != sizeof(TraceRecord)) {
+        throw std::runtime_error("Invalid trace file: " + path);
+    }
+    std::vector<TraceRecord> records(std::min<uint64_t>(header.written, header.capacity));
+    in.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(TraceRecord)));
+    records.resize(static_cast<size_t>(in.gcount()) / sizeof(TraceRecord));
+    return records;
+}
\ No newline at end of file
@@ -0,0 +1,529 @@
+#pragma once
+#include "vector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+// Невладеющие представления элементов Vector и ленивые конвейеры над ними:
+//     views::CollectInto(v | views::Filter(is_valid) | views::Transform(parse) | views::Take(100), out);
+// Стадии ничего не вычисляют и не выделяют память, пока результат не собирается CollectInto.
+// Если размер результата известен заранее (Transform, Take, Chunk и Zip над Span), память в out
+// резервируется один раз. Представления хранят ссылки на исходный вектор, поэтому не должны
+// переживать его и его перевыделения
+namespace views {
+
+// Базовый класс всех представлений, отличающий их от прочих типов в operator|
+struct ViewBase {};
+
+// Непрерывный участок элементов
+template <typename T>
+class Span : public ViewBase {
+public:
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+    static constexpr bool SIZED = true;
+
+    constexpr Span() = default;
+
+    constexpr Span(T* data, size_t size) noexcept
+        : data_(data)
+        , size_(size) {
+    }
+
+    constexpr Span(Vector<value_type>& v) noexcept
+        : data_(v.begin())
+        , size_(v.Size()) {
+    }
+
+    template <typename U = T, std::enable_if_t<std::is_const_v<U>, int> = 0>
+    constexpr Span(const Vector<value_type>& v) noexcept
+        : data_(v.begin())
+        , size_(v.Size()) {
+    }
+
+    template <typename U = T, std::enable_if_t<std::is_const_v<U>, int> = 0>
+    constexpr Span(Span<value_type> other) noexcept
+        : data_(other.begin())
+        , size_(other.Size()) {
+    }
+
+    constexpr iterator begin() const noexcept {
+        return data_;
+    }
+    constexpr iterator end() const noexcept {
+        return data_ + size_;
+    }
+
+    constexpr size_t Size() const noexcept {
+        return size_;
+    }
+
+    constexpr bool Empty() const noexcept {
+        return size_ == 0;
+    }
+
+    constexpr T& operator[](size_t index) const noexcept {
+        assert(index < size_);
+        return data_[index];
+    }
+
+    // Участок из не более чем count элементов, начиная с offset
+    constexpr Span Subspan(size_t offset, size_t count = SIZE_MAX) const noexcept {
+        assert(offset <= size_);
+        return Span(data_ + offset, std::min(count, size_ - offset));
+    }
+
+private:
+    T* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename T>
+constexpr Span<T> All(Vector<T>& v) noexcept {
+    return Span<T>(v);
+}
+
+template <typename T>
+constexpr Span<const T> All(const Vector<T>& v) noexcept {
+    return Span<const T>(v);
+}
+
+// Временный вектор был бы уничтожен раньше, чем представление над ним
+template <typename T>
+Span<const T> All(const Vector<T>&& v) = delete;
+
+template <typename View, std::enable_if_t<std::is_base_of_v<ViewBase, View>, int> = 0>
+constexpr View All(const View& view) {
+    return view;
+}
+
+template <typename Range>
+using AllT = decltype(All(std::declval<Range>()));
+
+// Общая часть итераторов представлений: итераторы однопроходные и сравниваются только
+// с итераторами того же представления
+template <typename Value>
+struct IteratorBase {
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Value;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+};
+
+// Элементы, для которых pred истинен
+template <typename View, typename Pred>
+class FilterView : public ViewBase {
+public:
+    using value_type = typename View::value_type;
+    static constexpr bool SIZED = false;
+
+    class iterator : public IteratorBase<value_type> {
+    public:
+        using Inner = decltype(std::declval<const View&>().begin());
+        using reference = decltype(*std::declval<Inner>());
+
+        iterator(const FilterView* view, Inner it)
+            : view_(view)
+            , it_(it) {
+            SkipRejected();
+        }
+
+        reference operator*() const {
+            return *it_;
+        }
+
+        iterator& operator++() {
+            ++it_;
+            SkipRejected();
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return it_ == other.it_;
+        }
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        void SkipRejected() {
+            const Inner end = view_->view_.end();
+            while (it_ != end && !view_->pred_(*it_)) {
+                ++it_;
+            }
+        }
+
+        const FilterView* view_;
+        Inner it_;
+    };
+
+    FilterView(View view, Pred pred)
+        : view_(std::move(view))
+        , pred_(std::move(pred)) {
+    }
+
+    iterator begin() const {
+        return iterator(this, view_.begin());
+    }
+    iterator end() const {
+        return iterator(this, view_.end());
+    }
+
+private:
+    View view_;
+    Pred pred_;
+};
+
+// Результаты func для каждого элемента
+template <typename View, typename Func>
+class TransformView : public ViewBase {
+    using Inner = decltype(std::declval<const View&>().begin());
+
+public:
+    using value_type = std::remove_cv_t<std::remove_reference_t<std::invoke_result_t<const Func&, decltype(*std::declval<Inner>())>>>;
+    static constexpr bool SIZED = View::SIZED;
+
+    class iterator : public IteratorBase<value_type> {
+    public:
+        using reference = std::invoke_result_t<const Func&, decltype(*std::declval<Inner>())>;
+
+        iterator(const TransformView* view, Inner it)
+            : view_(view)
+            , it_(it) {
+        }
+
+        reference operator*() const {
+            return view_->func_(*it_);
+        }
+
+        iterator& operator++() {
+            ++it_;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return it_ == other.it_;
+        }
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        const TransformView* view_;
+        Inner it_;
+    };
+
+    TransformView(View view, Func func)
+        : view_(std::move(view))
+        , func_(std::move(func)) {
+    }
+
+    iterator begin() const {
+        return iterator(this, view_.begin());
+    }
+    iterator end() const {
+        return iterator(this, view_.end());
+    }
+
+    template <typename V = View, std::enable_if_t<V::SIZED, int> = 0>
+    size_t Size() const {
+        return view_.Size();
+    }
+
+private:
+    View view_;
+    Func func_;
+};
+
+// Не более count первых элементов
+template <typename View>
+class TakeView : public ViewBase {
+    using Inner = decltype(std::declval<const View&>().begin());
+
+public:
+    using value_type = typename View::value_type;
+    static constexpr bool SIZED = View::SIZED;
+
+    class iterator : public IteratorBase<value_type> {
+    public:
+        using reference = decltype(*std::declval<Inner>());
+
+        iterator(Inner it, size_t remaining)
+            : it_(it)
+            , remaining_(remaining) {
+        }
+
+        reference operator*() const {
+            return *it_;
+        }
+
+        iterator& operator++() {
+            ++it_;
+            --remaining_;
+            return *this;
+        }
+
+        // Конец достигается либо исчерпанием count, либо концом исходного представления
+        bool operator==(const iterator& other) const {
+            return remaining_ == other.remaining_ || it_ == other.it_;
+        }
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        Inner it_;
+        size_t remaining_;
+    };
+
+    TakeView(View view, size_t count)
+        : view_(std::move(view))
+        , count_(count) {
+    }
+
+    iterator begin() const {
+        return iterator(view_.begin(), count_);
+    }
+    iterator end() const {
+        return iterator(view_.end(), 0);
+    }
+
+    template <typename V = View, std::enable_if_t<V::SIZED, int> = 0>
+    size_t Size() const {
+        return std::min(count_, view_.Size());
+    }
+
+private:
+    View view_;
+    size_t count_;
+};
+
+// Последовательные участки по size элементов (последний может быть короче).
+// Участки — это Span, поэтому делить можно только непрерывные элементы
+template <typename T>
+class ChunkView : public ViewBase {
+public:
+    using value_type = Span<T>;
+    static constexpr bool SIZED = true;
+
+    class iterator : public IteratorBase<value_type> {
+    public:
+        using reference = Span<T>;
+
+        iterator(Span<T> rest, size_t size)
+            : rest_(rest)
+            , size_(size) {
+        }
+
+        Span<T> operator*() const {
+            return rest_.Subspan(0, size_);
+        }
+
+        iterator& operator++() {
+            rest_ = rest_.Subspan(std::min(size_, rest_.Size()));
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return rest_.begin() == other.rest_.begin();
+        }
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        Span<T> rest_;
+        size_t size_;
+    };
+
+    ChunkView(Span<T> span, size_t size)
+        : span_(span)
+        , size_(size) {
+        assert(size > 0);
+    }
+
+    iterator begin() const {
+        return iterator(span_, size_);
+    }
+    iterator end() const {
+        return iterator(span_.Subspan(span_.Size()), size_);
+    }
+
+    size_t Size() const {
+        return (span_.Size() + size_ - 1) / size_;
+    }
+
+private:
+    Span<T> span_;
+    size_t size_;
+};
+
+// Пары элементов двух представлений с одинаковыми номерами; длина — по более короткому
+template <typename Left, typename Right>
+class ZipView : public ViewBase {
+    using LeftInner = decltype(std::declval<const Left&>().begin());
+    using RightInner = decltype(std::declval<const Right&>().begin());
+
+public:
+    using value_type = std::pair<typename Left::value_type, typename Right::value_type>;
+    static constexpr bool SIZED = Left::SIZED && Right::SIZED;
+
+    class iterator : public IteratorBase<value_type> {
+    public:
+        using reference = std::pair<decltype(*std::declval<LeftInner>()), decltype(*std::declval<RightInner>())>;
+
+        iterator(LeftInner left, RightInner right)
+            : left_(left)
+            , right_(right) {
+        }
+
+        reference operator*() const {
+            return reference(*left_, *right_);
+        }
+
+        iterator& operator++() {
+            ++left_;
+            ++right_;
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const {
+            return left_ == other.left_ || right_ == other.right_;
+        }
+        bool operator!=(const iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        LeftInner left_;
+        RightInner right_;
+    };
+
+    ZipView(Left left, Right right)
+        : left_(std::move(left))
+        , right_(std::move(right)) {
+    }
+
+    iterator begin() const {
+        return iterator(left_.begin(), right_.begin());
+    }
+    iterator end() const {
+        return iterator(left_.end(), right_.end());
+    }
+
+    template <bool Sized = SIZED, std::enable_if_t<Sized, int> = 0>
+    size_t Size() const {
+        return std::min(left_.Size(), right_.Size());
+    }
+
+private:
+    Left left_;
+    Right right_;
+};
+
+// Дописывает элементы представления в конец out. Ёмкость растёт хотя бы вдвое, как в EmplaceBack,
+// поэтому многократное дописывание в один вектор остаётся линейным
+template <typename View, typename T>
+void CollectInto(const View& view, Vector<T>& out) {
+    if constexpr (View::SIZED) {
+        const size_t size = out.Size() + view.Size();
+        if (size > out.Capacity()) {
+            out.Reserve(std::max(size, out.Capacity() * 2));
+        }
+    }
+    for (auto&& item : view) {
+        out.EmplaceBack(std::forward<decltype(item)>(item));
+    }
+}
+
+template <typename Left, typename Right>
+auto Zip(Left&& left, Right&& right) {
+    return ZipView<AllT<Left>, AllT<Right>>(All(std::forward<Left>(left)), All(std::forward<Right>(right)));
+}
+
+// Стадии конвейера для operator|: range | Filter(pred) равносильно FilterView(All(range), pred)
+struct AdaptorBase {};
+
+template <typename Pred>
+struct FilterAdaptor : AdaptorBase {
+    Pred pred;
+
+    template <typename View>
+    auto operator()(View view) const {
+        return FilterView<View, Pred>(std::move(view), pred);
+    }
+};
+
+template <typename Func>
+struct TransformAdaptor : AdaptorBase {
+    Func func;
+
+    template <typename View>
+    auto operator()(View view) const {
+        return TransformView<View, Func>(std::move(view), func);
+    }
+};
+
+struct TakeAdaptor : AdaptorBase {
+    size_t count;
+
+    template <typename View>
+    auto operator()(View view) const {
+        return TakeView<View>(std::move(view), count);
+    }
+};
+
+struct ChunkAdaptor : AdaptorBase {
+    size_t size;
+
+    template <typename T>
+    auto operator()(Span<T> span) const {
+        return ChunkView<T>(span, size);
+    }
+};
+
+template <typename T>
+struct CollectAdaptor : AdaptorBase {
+    Vector<T>* out;
+
+    template <typename View>
+    Vector<T>& operator()(const View& view) const {
+        CollectInto(view, *out);
+        return *out;
+    }
+};
+
+template <typename Pred>
+FilterAdaptor<Pred> Filter(Pred pred) {
+    return {{}, std::move(pred)};
+}
+
+template <typename Func>
+TransformAdaptor<Func> Transform(Func func) {
+    return {{}, std::move(func)};
+}
+
+inline TakeAdaptor Take(size_t count) {
+    return {{}, count};
+}
+
+inline ChunkAdaptor Chunk(size_t size) {
+    return {{}, size};
+}
+
+// range | CollectInto(out) дописывает элементы в out и возвращает его
+template <typename T>
+CollectAdaptor<T> CollectInto(Vector<T>& out) {
+    return {{}, &out};
+}
+
+template <typename Range, typename Adaptor, std::enable_if_t<std::is_base_of_v<AdaptorBase, Adaptor>, int> = 0>
+decltype(auto) operator|(Range&& range, const Adaptor& adaptor) {
+    return adaptor(All(std::forward<Range>(range)));
+}
+
+}  // namespace views
\ No newline at end of file